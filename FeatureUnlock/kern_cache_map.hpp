@@ -0,0 +1,593 @@
+//
+//  kern_cache_map.hpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+// File ranges of the images holding patch targets within a dyld shared cache.
+// The cache header maps image addresses to file offsets and lists every image by path,
+// the Mach-O load commands of each target image then give the sections worth scanning.
+// Split caches (macOS 12+) only list images in the main cache file, its sub cache table
+// tells which of the sub cache files hold the target images. Binaries patched outside of
+// the cache get the target sections of their x86_64 slices the same way.
+// Files are read through a callback, thus the same parser runs on a vnode in the kext
+// and on a plain file in the host tools.
+// Header is intentionally free of Lilu/XNU dependencies.
+
+#ifndef kern_cache_map_hpp
+#define kern_cache_map_hpp
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#pragma mark - Format
+
+// dyld_cache_header fields used, a field is only present when it ends before the mappings
+static constexpr char kDyldCacheMagic[] = "dyld_v1";
+static constexpr size_t kDyldCacheMappingOffset = 0x10;
+static constexpr size_t kDyldCacheMappingCount = 0x14;
+static constexpr size_t kDyldCacheImagesOffsetOld = 0x18;
+static constexpr size_t kDyldCacheImagesCountOld = 0x1C;
+static constexpr size_t kDyldCacheUuidOffset = 0x58;
+static constexpr size_t kDyldCacheSubCacheOffset = 0x188;
+static constexpr size_t kDyldCacheSubCacheCount = 0x18C;
+static constexpr size_t kDyldCacheImagesOffset = 0x1C0;
+static constexpr size_t kDyldCacheImagesCount = 0x1C4;
+static constexpr size_t kDyldCacheSubType = 0x1C8;  // sub cache entries gained a file suffix along with it
+static constexpr size_t kDyldCacheHeaderSize = 0x200;  // read upfront, covers every field used
+
+struct DyldCacheMapping {
+    uint64_t address;
+    uint64_t size;
+    uint64_t fileOffset;
+    uint32_t maxProt;
+    uint32_t initProt;
+};
+
+struct DyldCacheImage {
+    uint64_t address;
+    uint64_t modTime;
+    uint64_t inode;
+    uint32_t pathFileOffset;
+    uint32_t pad;
+};
+
+// Leading fields of dyld_subcache_entry, 24 bytes before the file suffix was added and 56 bytes after
+struct DyldSubCacheEntry {
+    uint8_t uuid[16];
+    uint64_t cacheVMOffset;  // from the first mapping of the main cache
+};
+
+static constexpr size_t kDyldSubCacheEntrySizeOld = 24;
+static constexpr size_t kDyldSubCacheEntrySize = 56;
+
+static_assert(sizeof(DyldCacheMapping) == 32 && sizeof(DyldCacheImage) == 32 && sizeof(DyldSubCacheEntry) == 24, "dyld cache structures mismatch");
+
+// Mach-O structures used, as in <mach-o/loader.h> and <mach-o/fat.h>
+static constexpr uint32_t kMachHeader64Magic = 0xFEEDFACF;
+static constexpr uint32_t kMachLoadSegment64 = 0x19;
+static constexpr uint32_t kMachCpuTypeX86_64 = 0x01000007;
+static constexpr uint32_t kFatMagic = 0xCAFEBABE;    // big endian, as every fat header field
+static constexpr uint32_t kFatMagic64 = 0xCAFEBABF;
+static constexpr size_t kFatArchSize = 20;
+static constexpr size_t kFatArch64Size = 32;
+static constexpr size_t kMaxFatArchs = 8;
+
+struct MachHeader64 {
+    uint32_t magic;
+    uint32_t cpuType;
+    uint32_t cpuSubtype;
+    uint32_t fileType;
+    uint32_t commandCount;
+    uint32_t commandSize;
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+struct MachLoadCommand {
+    uint32_t cmd;
+    uint32_t size;
+};
+
+struct MachSegment64 {
+    uint32_t cmd;
+    uint32_t size;
+    char name[16];
+    uint64_t address;
+    uint64_t addressSize;
+    uint64_t fileOffset;
+    uint64_t fileSize;
+    uint32_t maxProt;
+    uint32_t initProt;
+    uint32_t sectionCount;
+    uint32_t flags;
+};
+
+struct MachSection64 {
+    char name[16];
+    char segment[16];
+    uint64_t address;
+    uint64_t size;
+    uint32_t fileOffset;
+    uint32_t align;
+    uint32_t relocationOffset;
+    uint32_t relocationCount;
+    uint32_t flags;
+    uint32_t reserved[3];
+};
+
+static_assert(sizeof(MachHeader64) == 32 && sizeof(MachSegment64) == 72 && sizeof(MachSection64) == 80, "Mach-O structures mismatch");
+
+static inline uint32_t readUInt32(const uint8_t *data) {
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static inline uint32_t readBigUInt32(const uint8_t *data) {
+    return __builtin_bswap32(readUInt32(data));
+}
+
+static inline uint64_t readBigUInt64(const uint8_t *data) {
+    return static_cast<uint64_t>(readBigUInt32(data)) << 32 | readBigUInt32(data + sizeof(uint32_t));
+}
+
+// Calls visit with every section of the named segment, false when the load commands are cut short or malformed
+template <typename Visit>
+static bool forEachMachSection(const uint8_t *commands, size_t size, uint32_t count, const char *segment, Visit visit) {
+    size_t at = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (size - at < sizeof(MachLoadCommand)) {
+            return false;
+        }
+        MachLoadCommand command;
+        memcpy(&command, commands + at, sizeof(command));
+        if (command.size < sizeof(MachLoadCommand) || command.size > size - at) {
+            return false;
+        }
+        if (command.cmd == kMachLoadSegment64 && command.size >= sizeof(MachSegment64)) {
+            MachSegment64 header;
+            memcpy(&header, commands + at, sizeof(header));
+            if (strncmp(header.name, segment, sizeof(header.name)) == 0) {
+                if (header.sectionCount > (command.size - sizeof(MachSegment64)) / sizeof(MachSection64)) {
+                    return false;
+                }
+                for (uint32_t s = 0; s < header.sectionCount; s++) {
+                    MachSection64 section;
+                    memcpy(&section, commands + at + sizeof(MachSegment64) + s * sizeof(MachSection64), sizeof(section));
+                    visit(header, section);
+                }
+            }
+        }
+        at += command.size;
+    }
+    return true;
+}
+
+static inline bool machSectionNamed(const MachSection64 &section, const char *const *names, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (strncmp(section.name, names[i], sizeof(section.name)) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#pragma mark - Target ranges
+
+struct CacheRange {
+    uint64_t begin;  // file offsets
+    uint64_t end;    // exclusive
+};
+
+enum class CacheMapStatus : uint8_t {
+    Mapped,     // ranges cover every target section held by the file
+    NotCache,   // file does not start with a dyld_cache_header
+    NoTargets,  // file holds none of the target images, no page needs scanning
+    SubCache,   // sub cache file of a main cache whose layout is not known
+    Malformed,  // a structure is out of bounds or could not be read
+    Overflow,   // more target sections, images or sub caches than fit
+};
+
+// Reads exactly size bytes at a file offset
+using CacheReader = bool (*)(void *context, uint64_t offset, void *buffer, size_t size);
+
+static constexpr size_t kMaxCacheMappings = 16;
+static constexpr size_t kCacheImageBatch = 64;
+static constexpr size_t kCacheReadBlock = 4096;
+static constexpr size_t kMaxCacheImagePath = 256;
+static constexpr size_t kMaxMachCommandsSize = 8192;  // __TEXT comes first, later commands may be cut
+static constexpr size_t kMaxCacheTargetImages = 16;
+static constexpr size_t kMaxCacheSubCaches = 32;
+
+struct CacheSubCache {
+    uint8_t uuid[16];
+    bool target;  // holds the __TEXT of a target image
+};
+
+// What sub cache files need from their main cache file, valid when subCacheCount is not 0
+struct CacheLayout {
+    uint64_t images[kMaxCacheTargetImages];  // addresses of the target images
+    size_t imageCount;
+    CacheSubCache subCaches[kMaxCacheSubCaches];
+    size_t subCacheCount;
+};
+
+// Buffers of mapCacheTargets, too large for a kernel stack
+struct CacheMapScratch {
+    uint8_t header[kDyldCacheHeaderSize];
+    DyldCacheMapping mappings[kMaxCacheMappings];
+    DyldCacheImage images[kCacheImageBatch];
+    uint8_t block[kCacheReadBlock];  // path strings are read a block at a time
+    uint64_t blockOffset;
+    size_t blockSize;
+    uint8_t commands[kMaxMachCommandsSize];
+    CacheLayout layout;  // of the last main cache file mapped
+};
+
+struct CacheTargets {
+    const char *const *images;    // path fragments of the target images, ie. "/SidecarCore.framework/"
+    size_t imageCount;
+    const char *const *sections;  // __TEXT sections holding the needles
+    size_t sectionCount;
+};
+
+// File offset of [address, address + size), false when no mapping of the file holds all of it
+static inline bool cacheFileOffset(const DyldCacheMapping *mappings, size_t count, uint64_t address, uint64_t size, uint64_t &offset) {
+    for (size_t i = 0; i < count; i++) {
+        const DyldCacheMapping &mapping = mappings[i];
+        if (address >= mapping.address && address - mapping.address <= mapping.size && size <= mapping.size - (address - mapping.address)) {
+            offset = mapping.fileOffset + (address - mapping.address);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Reads the NUL terminated string at offset through the block buffer, false when longer than size
+static bool readCacheString(CacheReader read, void *context, uint64_t fileSize, CacheMapScratch &scratch, uint64_t offset, char *string, size_t size) {
+    for (size_t i = 0; i < size; i++, offset++) {
+        if (offset < scratch.blockOffset || offset - scratch.blockOffset >= scratch.blockSize) {
+            if (offset >= fileSize) {
+                return false;
+            }
+            scratch.blockOffset = offset - offset % kCacheReadBlock;
+            scratch.blockSize = static_cast<size_t>(fileSize - scratch.blockOffset < kCacheReadBlock ? fileSize - scratch.blockOffset : kCacheReadBlock);
+            if (!read(context, scratch.blockOffset, scratch.block, scratch.blockSize)) {
+                scratch.blockSize = 0;
+                return false;
+            }
+        }
+        string[i] = static_cast<char>(scratch.block[offset - scratch.blockOffset]);
+        if (string[i] == '\0') {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool isCacheTargetImage(const char *path, const CacheTargets &targets) {
+    for (size_t i = 0; i < targets.imageCount; i++) {
+        if (strstr(path, targets.images[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool addCacheRange(CacheRange *ranges, size_t &count, size_t maxCount, uint64_t begin, uint64_t end) {
+    // Kept sorted and merged, there are only a few dozen at most
+    size_t at = 0;
+    while (at < count && ranges[at].end < begin) {
+        at++;
+    }
+    if (at < count && ranges[at].begin <= end) {
+        ranges[at].begin = ranges[at].begin < begin ? ranges[at].begin : begin;
+        ranges[at].end = ranges[at].end > end ? ranges[at].end : end;
+        while (at + 1 < count && ranges[at + 1].begin <= ranges[at].end) {
+            ranges[at].end = ranges[at + 1].end > ranges[at].end ? ranges[at + 1].end : ranges[at].end;
+            memmove(&ranges[at + 1], &ranges[at + 2], (count - at - 2) * sizeof(CacheRange));
+            count--;
+        }
+        return true;
+    }
+    if (count == maxCount) {
+        return false;
+    }
+    memmove(&ranges[at + 1], &ranges[at], (count - at) * sizeof(CacheRange));
+    ranges[at] = {begin, end};
+    count++;
+    return true;
+}
+
+// Adds the target sections of __TEXT in the load commands, the whole segment when it has none of them.
+// Offset gives the file offset of a segment or section from its address, size and Mach-O file offset.
+template <typename Offset>
+static CacheMapStatus addMachRanges(const uint8_t *commands, size_t size, uint32_t commandCount, const char *const *sections, size_t sectionCount,
+                                    Offset offset, CacheRange *ranges, size_t &count, size_t maxCount) {
+    bool malformed = false;
+    bool overflow = false;
+    bool found = false;
+    bool segment = false;
+    CacheRange text {};
+    forEachMachSection(commands, size, commandCount, "__TEXT", [&](const MachSegment64 &command, const MachSection64 &section) {
+        if (!segment) {
+            segment = true;
+            malformed |= !offset(command.address, command.fileOffset, command.fileSize, text.begin);
+            text.end = text.begin + command.fileSize;
+        }
+        if (!machSectionNamed(section, sections, sectionCount) || section.size == 0) {
+            return;
+        }
+        uint64_t begin;
+        if (!offset(section.address, section.fileOffset, section.size, begin)) {
+            malformed = true;
+            return;
+        }
+        found = true;
+        overflow |= !addCacheRange(ranges, count, maxCount, begin, begin + section.size);
+    });
+    // Commands cut short are only trusted not to hold another __TEXT once it was seen
+    if (malformed || !segment) {
+        return CacheMapStatus::Malformed;
+    }
+    if (!found) {
+        overflow |= !addCacheRange(ranges, count, maxCount, text.begin, text.end);
+    }
+    return overflow ? CacheMapStatus::Overflow : CacheMapStatus::Mapped;
+}
+
+// Adds the target sections of the image at address, held tells whether the file holds its header
+static CacheMapStatus mapCacheImage(CacheReader read, void *context, CacheMapScratch &scratch, size_t mappingCount, uint64_t address,
+                                    const CacheTargets &targets, CacheRange *ranges, size_t &count, size_t maxCount, bool &held) {
+    uint64_t offset;
+    held = cacheFileOffset(scratch.mappings, mappingCount, address, sizeof(MachHeader64), offset);
+    if (!held) {
+        return CacheMapStatus::Mapped;
+    }
+    MachHeader64 header;
+    if (!read(context, offset, &header, sizeof(header)) || header.magic != kMachHeader64Magic) {
+        return CacheMapStatus::Malformed;
+    }
+    size_t size = header.commandSize < kMaxMachCommandsSize ? header.commandSize : kMaxMachCommandsSize;
+    if (!cacheFileOffset(scratch.mappings, mappingCount, address, sizeof(header) + size, offset) ||
+        !read(context, offset + sizeof(header), scratch.commands, size)) {
+        return CacheMapStatus::Malformed;
+    }
+    // Images share the file offsets of the cache, the mappings translate their addresses
+    auto cacheOffset = [&](uint64_t address, uint64_t, uint64_t size, uint64_t &begin) {
+        return cacheFileOffset(scratch.mappings, mappingCount, address, size, begin);
+    };
+    return addMachRanges(scratch.commands, size, header.commandCount, targets.sections, targets.sectionCount, cacheOffset, ranges, count, maxCount);
+}
+
+static bool addCacheImage(CacheLayout &layout, uint64_t address) {
+    for (size_t i = 0; i < layout.imageCount; i++) {
+        if (layout.images[i] == address) {
+            return true;
+        }
+    }
+    if (layout.imageCount == kMaxCacheTargetImages) {
+        return false;
+    }
+    layout.images[layout.imageCount++] = address;
+    return true;
+}
+
+// Flags the sub caches holding target images not held by the main cache file itself
+static CacheMapStatus mapCacheSubCaches(CacheReader read, void *context, uint64_t fileSize, CacheMapScratch &scratch, size_t mappingCount) {
+    CacheLayout &layout = scratch.layout;
+    uint32_t mappingOffset = readUInt32(scratch.header + kDyldCacheMappingOffset);
+    if (mappingOffset < kDyldCacheSubCacheCount + sizeof(uint32_t)) {
+        return CacheMapStatus::Mapped;
+    }
+    uint32_t tableOffset = readUInt32(scratch.header + kDyldCacheSubCacheOffset);
+    uint32_t tableCount = readUInt32(scratch.header + kDyldCacheSubCacheCount);
+    size_t entrySize = mappingOffset <= kDyldCacheSubType ? kDyldSubCacheEntrySizeOld : kDyldSubCacheEntrySize;
+    if (tableCount > kMaxCacheSubCaches) {
+        return CacheMapStatus::Overflow;
+    }
+    if (tableOffset + static_cast<uint64_t>(tableCount) * entrySize > fileSize) {
+        return CacheMapStatus::Malformed;
+    }
+
+    // Sub caches follow each other in memory, each one holds the images from its offset to the next one
+    uint64_t vmOffsets[kMaxCacheSubCaches];
+    for (uint32_t i = 0; i < tableCount; i++) {
+        DyldSubCacheEntry entry;
+        if (!read(context, tableOffset + static_cast<uint64_t>(i) * entrySize, &entry, sizeof(entry))) {
+            return CacheMapStatus::Malformed;
+        }
+        memcpy(layout.subCaches[i].uuid, entry.uuid, sizeof(entry.uuid));
+        layout.subCaches[i].target = false;
+        vmOffsets[i] = entry.cacheVMOffset;
+    }
+    uint64_t base = scratch.mappings[0].address;
+    for (size_t i = 0; i < layout.imageCount; i++) {
+        uint64_t offset;
+        if (cacheFileOffset(scratch.mappings, mappingCount, layout.images[i], sizeof(MachHeader64), offset) || layout.images[i] < base) {
+            continue;
+        }
+        size_t holder = tableCount;
+        for (uint32_t s = 0; s < tableCount; s++) {
+            if (vmOffsets[s] <= layout.images[i] - base && (holder == tableCount || vmOffsets[s] > vmOffsets[holder])) {
+                holder = s;
+            }
+        }
+        if (holder == tableCount) {
+            return CacheMapStatus::Malformed;
+        }
+        layout.subCaches[holder].target = true;
+    }
+    layout.subCacheCount = tableCount;
+    return CacheMapStatus::Mapped;
+}
+
+// Sorted file ranges of the target sections held by the cache file of the given size.
+// Main cache files of split caches leave their layout in scratch.layout, sub cache files
+// are then mapped from the layout of their main cache, found by UUID among layouts.
+static inline CacheMapStatus mapCacheTargets(CacheReader read, void *context, uint64_t fileSize, const CacheTargets &targets, const CacheLayout *layouts,
+                                             size_t layoutCount, CacheMapScratch &scratch, CacheRange *ranges, size_t &count, size_t maxCount) {
+    count = 0;
+    scratch.blockOffset = 0;
+    scratch.blockSize = 0;
+    scratch.layout.imageCount = 0;
+    scratch.layout.subCacheCount = 0;
+    if (fileSize < kDyldCacheHeaderSize || !read(context, 0, scratch.header, kDyldCacheHeaderSize)) {
+        return CacheMapStatus::NotCache;
+    }
+    if (memcmp(scratch.header, kDyldCacheMagic, sizeof(kDyldCacheMagic) - 1) != 0) {
+        return CacheMapStatus::NotCache;
+    }
+    uint32_t mappingOffset = readUInt32(scratch.header + kDyldCacheMappingOffset);
+    uint32_t mappingCount = readUInt32(scratch.header + kDyldCacheMappingCount);
+    if (mappingCount == 0 || mappingCount > kMaxCacheMappings || mappingOffset + mappingCount * sizeof(DyldCacheMapping) > fileSize ||
+        !read(context, mappingOffset, scratch.mappings, mappingCount * sizeof(DyldCacheMapping))) {
+        return CacheMapStatus::Malformed;
+    }
+    // Newer headers moved the image table past the old fields, leaving them zero
+    uint32_t imagesOffset = readUInt32(scratch.header + kDyldCacheImagesOffsetOld);
+    uint32_t imagesCount = readUInt32(scratch.header + kDyldCacheImagesCountOld);
+    if (mappingOffset >= kDyldCacheImagesCount + sizeof(uint32_t) && imagesOffset == 0) {
+        imagesOffset = readUInt32(scratch.header + kDyldCacheImagesOffset);
+        imagesCount = readUInt32(scratch.header + kDyldCacheImagesCount);
+    }
+
+    // Sub cache files list no image, their main cache tells whether they hold any target
+    if (imagesCount == 0) {
+        const uint8_t *uuid = scratch.header + kDyldCacheUuidOffset;
+        for (size_t l = 0; l < layoutCount; l++) {
+            for (size_t s = 0; s < layouts[l].subCacheCount; s++) {
+                if (memcmp(layouts[l].subCaches[s].uuid, uuid, sizeof(layouts[l].subCaches[s].uuid)) != 0) {
+                    continue;
+                }
+                if (!layouts[l].subCaches[s].target) {
+                    return CacheMapStatus::NoTargets;
+                }
+                for (size_t i = 0; i < layouts[l].imageCount; i++) {
+                    bool held;
+                    CacheMapStatus status = mapCacheImage(read, context, scratch, mappingCount, layouts[l].images[i], targets, ranges, count, maxCount, held);
+                    if (status != CacheMapStatus::Mapped) {
+                        return status;
+                    }
+                }
+                return count > 0 ? CacheMapStatus::Mapped : CacheMapStatus::NoTargets;
+            }
+        }
+        return CacheMapStatus::SubCache;
+    }
+    if (imagesOffset + static_cast<uint64_t>(imagesCount) * sizeof(DyldCacheImage) > fileSize) {
+        return CacheMapStatus::Malformed;
+    }
+
+    size_t held = 0;
+    for (uint32_t first = 0; first < imagesCount; first += kCacheImageBatch) {
+        uint32_t batch = imagesCount - first < kCacheImageBatch ? imagesCount - first : kCacheImageBatch;
+        if (!read(context, imagesOffset + static_cast<uint64_t>(first) * sizeof(DyldCacheImage), scratch.images, batch * sizeof(DyldCacheImage))) {
+            return CacheMapStatus::Malformed;
+        }
+        for (uint32_t i = 0; i < batch; i++) {
+            char path[kMaxCacheImagePath];
+            DyldCacheImage image = scratch.images[i];
+            if (!readCacheString(read, context, fileSize, scratch, image.pathFileOffset, path, sizeof(path)) || !isCacheTargetImage(path, targets)) {
+                continue;
+            }
+            if (!addCacheImage(scratch.layout, image.address)) {
+                return CacheMapStatus::Overflow;
+            }
+            bool inFile;
+            CacheMapStatus status = mapCacheImage(read, context, scratch, mappingCount, image.address, targets, ranges, count, maxCount, inFile);
+            if (status != CacheMapStatus::Mapped) {
+                return status;
+            }
+            held += inFile;
+        }
+    }
+    CacheMapStatus status = mapCacheSubCaches(read, context, fileSize, scratch, mappingCount);
+    if (status != CacheMapStatus::Mapped) {
+        scratch.layout.subCacheCount = 0;
+        return status;
+    }
+    return held > 0 ? CacheMapStatus::Mapped : CacheMapStatus::NoTargets;
+}
+
+// Adds the target sections of the Mach-O slice at [begin, end) of the file
+static CacheMapStatus mapMachSlice(CacheReader read, void *context, CacheMapScratch &scratch, uint64_t begin, uint64_t end,
+                                   const char *const *sections, size_t sectionCount, CacheRange *ranges, size_t &count, size_t maxCount) {
+    MachHeader64 header;
+    if (end - begin < sizeof(header) || !read(context, begin, &header, sizeof(header)) || header.magic != kMachHeader64Magic) {
+        return CacheMapStatus::Malformed;
+    }
+    size_t size = header.commandSize < kMaxMachCommandsSize ? header.commandSize : kMaxMachCommandsSize;
+    if (size > end - begin - sizeof(header) || !read(context, begin + sizeof(header), scratch.commands, size)) {
+        return CacheMapStatus::Malformed;
+    }
+    // Mach-O file offsets are relative to the slice
+    auto sliceOffset = [&](uint64_t, uint64_t fileOffset, uint64_t size, uint64_t &at) {
+        at = begin + fileOffset;
+        return fileOffset <= end - begin && size <= end - begin - fileOffset;
+    };
+    return addMachRanges(scratch.commands, size, header.commandCount, sections, sectionCount, sliceOffset, ranges, count, maxCount);
+}
+
+// Sorted file ranges of the target sections of every x86_64 slice of a thin or fat Mach-O file
+static inline CacheMapStatus mapMachTargets(CacheReader read, void *context, uint64_t fileSize, const char *const *sections, size_t sectionCount,
+                                            CacheMapScratch &scratch, CacheRange *ranges, size_t &count, size_t maxCount) {
+    count = 0;
+    size_t headerSize = static_cast<size_t>(fileSize < kDyldCacheHeaderSize ? fileSize : kDyldCacheHeaderSize);
+    if (headerSize < sizeof(uint32_t) || !read(context, 0, scratch.header, headerSize)) {
+        return CacheMapStatus::Malformed;
+    }
+    if (readUInt32(scratch.header) == kMachHeader64Magic) {
+        return mapMachSlice(read, context, scratch, 0, fileSize, sections, sectionCount, ranges, count, maxCount);
+    }
+    uint32_t magic = readBigUInt32(scratch.header);
+    if ((magic != kFatMagic && magic != kFatMagic64) || headerSize < 2 * sizeof(uint32_t)) {
+        return CacheMapStatus::Malformed;
+    }
+    uint32_t archCount = readBigUInt32(scratch.header + sizeof(uint32_t));
+    size_t archSize = magic == kFatMagic64 ? kFatArch64Size : kFatArchSize;
+    if (archCount > kMaxFatArchs || 2 * sizeof(uint32_t) + archCount * archSize > headerSize) {
+        return CacheMapStatus::Malformed;
+    }
+    bool mapped = false;
+    for (uint32_t i = 0; i < archCount; i++) {
+        // Only x86_64 and x86_64h slices run on the hosts patched
+        const uint8_t *arch = scratch.header + 2 * sizeof(uint32_t) + i * archSize;
+        if (readBigUInt32(arch) != kMachCpuTypeX86_64) {
+            continue;
+        }
+        uint64_t offset = magic == kFatMagic64 ? readBigUInt64(arch + 8) : readBigUInt32(arch + 8);
+        uint64_t size = magic == kFatMagic64 ? readBigUInt64(arch + 16) : readBigUInt32(arch + 12);
+        if (offset > fileSize || size > fileSize - offset) {
+            return CacheMapStatus::Malformed;
+        }
+        CacheMapStatus status = mapMachSlice(read, context, scratch, offset, offset + size, sections, sectionCount, ranges, count, maxCount);
+        if (status != CacheMapStatus::Mapped) {
+            return status;
+        }
+        mapped = true;
+    }
+    return mapped ? CacheMapStatus::Mapped : CacheMapStatus::NoTargets;
+}
+
+// Whether [offset, offset + size) intersects any of the sorted ranges
+static inline bool intersectsCacheRanges(const CacheRange *ranges, size_t count, uint64_t offset, uint64_t size) {
+    // First range ending past offset
+    const CacheRange *first = ranges;
+    const CacheRange *last = ranges + count;
+    while (count > 0) {
+        size_t half = count / 2;
+        if (first[half].end <= offset) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    return first != last && first->begin < offset + size;
+}
+
+#endif /* kern_cache_map_hpp */
@@ -10,7 +10,14 @@
 // Note the dyld patching is done recursively so all matching bytes are patched
 // When developing new patch sets, ensure that all patches applied are intentional
 
+#ifndef kern_dyld_patch_hpp
+#define kern_dyld_patch_hpp
+
 #include <stdint.h>
+#include "kern_matcher.hpp"
+#include "kern_signature.hpp"
+#include "kern_cache_map.hpp"
+
 #pragma mark - Sidecar/AirPlay Patch Set
 
 // SidecarCore/AirPlaySupport share 1 large array of unsupported models.
@@ -42,325 +49,8 @@
 // Note Macmini was mistyped as MacMini in 12.0 - 12.3 B1, however was resolved with 12.3 B2 (21E5206e):
 // https://www.apple.com/macos/monterey/features/
 
-static const uint8_t kSideCarAirPlayiMacOriginal[] = {
-    // iMac13,1 iMac13,2 iMac13,3 iMac14,1 iMac14,2 iMac14,3 iMac14,4 iMac15,1 iMac16,1 iMac16,2
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x31, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x32, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x33, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x31, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x32, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x33, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x34, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x35, 0x2C, 0x31, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x31, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x32, 0x00,
-};
-
-static const uint8_t kSideCarAirPlayiMacAlternative2012Original[] {
-    // iMac13,1 iMac13,2 iMac13,3
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x31, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x32, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x33, 0x00,
-};
-static const uint8_t kSideCarAirPlayiMacAlternative2013Original[] {
-    // iMac14,1 iMac14,2 iMac14,3 iMac14,4
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x31, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x32, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x33, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x34, 0x00,
-};
-static const uint8_t kSideCarAirPlayiMacAlternative2014Original[] {
-    // iMac15,1 iMac16,1 iMac16,2
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x35, 0x2C, 0x31, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x31, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x32, 0x00,
-};
-
-static const uint8_t kSideCarAirPlayMacBookOriginal[] = {
-    // MacBook8,1
-    // MacBookAir5,1 MacBookAir5,2 MacBookAir6,1 MacBookAir6,2 MacBookAir7,1 MacBookAir7,2
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x38, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x35, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x35, 0x2C, 0x32, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x36, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x36, 0x2C, 0x32, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x32, 0x00,
-};
-
-static const uint8_t kSideCarAirPlayMacBookMacBookAir2012Original[] = {
-    // MacBook8,1
-    // MacBookAir5,1 MacBookAir5,2
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x38, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x35, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x35, 0x2C, 0x32, 0x00,
-};
-
-static const uint8_t kSideCarAirPlayMacBookAir2013_2015Original[] = {
-    // MacBookAir6,1 MacBookAir6,2 MacBookAir7,1 MacBookAir7,2
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x36, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x36, 0x2C, 0x32, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x32, 0x00,
-};
-
-
-static const uint8_t kSideCarAirPlayMacBookProOriginal[] = {
-    // MacBookPro9,1 MacBookPro9,2 MacBookPro10,1 MacBookPro10,2
-    // MacBookPro11,1 MacBookPro11,2 MacBookPro11,3 MacBookPro11,4 MacBookPro11,5 MacBookPro12,1
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x39, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x39, 0x2C, 0x32, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x30, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x30, 0x2C, 0x32, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x32, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x33, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x34, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x35, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x32, 0x2C, 0x31, 0x00,
-};
-
-static const uint8_t kSideCarAirPlayMacBookPro2012Original[] = {
-    // MacBookPro9,1 MacBookPro9,2 MacBookPro10,1 MacBookPro10,2
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x39, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x39, 0x2C, 0x32, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x30, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x30, 0x2C, 0x32, 0x00,
-};
-
-static const uint8_t kSideCarAirPlayMacBookPro2013_2015Original[] = {
-    // MacBookPro11,1 MacBookPro11,2 MacBookPro11,3 MacBookPro11,4 MacBookPro11,5 MacBookPro12,1
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x32, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x33, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x34, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x35, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x32, 0x2C, 0x31, 0x00,
-};
-
-
-static const uint8_t kSideCarAirPlayStandaloneDesktopOriginal[] = {
-    // Macmini6,1 Macmini6,2 Macmini7,1
-    // MacPro5,1 MacPro6,1
-    0x4D, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x36, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x36, 0x2C, 0x32, 0x00,
-    0x4D, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x37, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x35, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x36, 0x2C, 0x31
-};
-
-static const uint8_t kSideCarAirPlayMacProOriginal[] = {
-    // MacPro5,1 MacPro6,1
-    0x4D, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x35, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x36, 0x2C, 0x31
-};
-
-
-static const uint8_t kSideCarAirPlayMacminiOriginal[] = {
-    // Macmini6,1 Macmini6,2 Macmini7,1
-    0x4D, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x36, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x36, 0x2C, 0x32, 0x00,
-    0x4D, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x37, 0x2C, 0x31, 0x00,
-};
-
-
-static const uint8_t kSideCarAirPlayiMacPatched[] = {
-    // iNac13,1 iNac13,2 iNac13,3 iNac14,1 iNac14,2 iNac14,3 iNac14,4 iNac15,1 iNac16,1 iNac16,2
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x31, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x32, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x33, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x31, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x32, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x33, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x34, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x35, 0x2C, 0x31, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x31, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x32, 0x00,
-};
-
-static const uint8_t kSideCarAirPlayiMacAlternative2012Patched[] {
-    // iNac13,1 iNac13,2 iNac13,3
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x31, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x32, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x33, 0x00,
-};
-static const uint8_t kSideCarAirPlayiMacAlternative2013Patched[] {
-    // iNac14,1 iNac14,2 iNac14,3 iNac14,4
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x31, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x32, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x33, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x34, 0x00,
-};
-static const uint8_t kSideCarAirPlayiMacAlternative2014Patched[] {
-    // iNac15,1 iNac16,1 iNac16,2
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x35, 0x2C, 0x31, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x31, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x32, 0x00,
-};
-
-static const uint8_t kSideCarAirPlayMacBookPatched[] = {
-    // NacBook8,1
-    // NacBookAir5,1 NacBookAir5,2 NacBookAir6,1 NacBookAir6,2 NacBookAir7,1 NacBookAir7,2
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x38, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x35, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x35, 0x2C, 0x32, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x36, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x36, 0x2C, 0x32, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x32, 0x00,
-};
-
-static const uint8_t kSideCarAirPlayMacBooMacBookAir2012Patched[] = {
-    // NacBook8,1
-    // NacBookAir5,1 NacBookAir5,2
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x38, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x35, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x35, 0x2C, 0x32, 0x00,
-};
-
-static const uint8_t kSideCarAirPlayMacBookAir2013_2015Patched[] = {
-    // NacBookAir6,1 NacBookAir6,2 NacBookAir7,1 NacBookAir7,2
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x36, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x36, 0x2C, 0x32, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x32, 0x00,
-};
-
-
-static const uint8_t kSideCarAirPlayMacBookProPatched[] = {
-    // NacBookPro9,1 NacBookPro9,2 NacBookPro10,1 NacBookPro10,2
-    // NacBookPro11,1 NacBookPro11,2 NacBookPro11,3 NacBookPro11,4 NacBookPro11,5 NacBookPro12,1
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x39, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x39, 0x2C, 0x32, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x30, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x30, 0x2C, 0x32, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x32, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x33, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x34, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x35, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x32, 0x2C, 0x31, 0x00,
-};
-
-static const uint8_t kSideCarAirPlayMacBookPro2012Patched[] = {
-    // NacBookPro9,1 NacBookPro9,2 NacBookPro10,1 NacBookPro10,2
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x39, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x39, 0x2C, 0x32, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x30, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x30, 0x2C, 0x32, 0x00,
-};
-
-static const uint8_t kSideCarAirPlayMacBookPro2013_2015Patched[] = {
-    // NacBookPro11,1 NacBookPro11,2 NacBookPro11,3 NacBookPro11,4 NacBookPro11,5 NacBookPro12,1
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x32, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x33, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x34, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x35, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x32, 0x2C, 0x31, 0x00,
-};
-
-
-static const uint8_t kSideCarAirPlayStandaloneDesktopPatched[] = {
-    // Nacmini6,1 Nacmini6,2 Nacmini7,1
-    // NacPro5,1 NacPro6,1
-    0x4E, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x36, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x36, 0x2C, 0x32, 0x00,
-    0x4E, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x37, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x35, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x36, 0x2C, 0x31
-};
-
-static const uint8_t kSideCarAirPlayMacminiPatched[] = {
-    // Nacmini6,1 Nacmini6,2 Nacmini7,1
-    0x4E, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x36, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x36, 0x2C, 0x32, 0x00,
-    0x4E, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x37, 0x2C, 0x31, 0x00,
-};
-
-static const uint8_t kSideCarAirPlayMacProPatched[] = {
-    // NacPro5,1 NacPro6,1
-    0x4E, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x35, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x36, 0x2C, 0x31
-};
-
-// SidecarCore.framework
-// Replaces iPad with hPad
-static const uint8_t kSidecariPadModelOriginal[] = {
-    // iPad4,1 iPad4,2 iPad4,3 iPad4,4 iPad4,5 iPad4,6 iPad4,7 iPad4,8 iPad4,9
-    // iPad5,1 iPad5,2 iPad5,3 iPad5,4 iPad6,11 iPad6,12
-    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x31, 0x00,
-    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x32, 0x00,
-    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x33, 0x00,
-    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x34, 0x00,
-    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x35, 0x00,
-    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x36, 0x00,
-    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x37, 0x00,
-    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x38, 0x00,
-    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x39, 0x00,
-    0x69, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x31, 0x00,
-    0x69, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x32, 0x00,
-    0x69, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x33, 0x00,
-    0x69, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x34, 0x00,
-    0x69, 0x50, 0x61, 0x64, 0x36, 0x2C, 0x31, 0x31, 0x00,
-    0x69, 0x50, 0x61, 0x64, 0x36, 0x2C, 0x31, 0x32
-};
-
-static const uint8_t kSidecariPadModelPatched[] = {
-    // hPad4,1 hPad4,2 hPad4,3 hPad4,4 hPad4,5 hPad4,6 hPad4,7 hPad4,8 hPad4,9
-    // hPad5,1 hPad5,2 hPad5,3 hPad5,4 hPad6,11 hPad6,12
-    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x31, 0x00,
-    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x32, 0x00,
-    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x33, 0x00,
-    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x34, 0x00,
-    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x35, 0x00,
-    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x36, 0x00,
-    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x37, 0x00,
-    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x38, 0x00,
-    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x39, 0x00,
-    0x68, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x31, 0x00,
-    0x68, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x32, 0x00,
-    0x68, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x33, 0x00,
-    0x68, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x34, 0x00,
-    0x68, 0x50, 0x61, 0x64, 0x36, 0x2C, 0x31, 0x31, 0x00,
-    0x68, 0x50, 0x61, 0x64, 0x36, 0x2C, 0x31, 0x32
-};
-
-// AirPlaySupport.framework
-// Replaces Mac with Nac
-static const uint8_t kMacModelAirplayExtendedOriginal[] = {
-    // iMac17,1 iMac18,1 iMac18,2 iMac18,3
-    // MacBookPro13,1 MacBookPro13,2 MacBookPro13,3 MacBookPro14,1 MacBookPro14,2 MacBookPro14,3
-    // MacMini8,1
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x37, 0x2C, 0x31, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x38, 0x2C, 0x31, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x38, 0x2C, 0x32, 0x00,
-    0x69, 0x4D, 0x61, 0x63, 0x31, 0x38, 0x2C, 0x33, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x33, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x33, 0x2C, 0x32, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x33, 0x2C, 0x33, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x34, 0x2C, 0x31, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x34, 0x2C, 0x32, 0x00,
-    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x34, 0x2C, 0x33, 0x00,
-    0x4D, 0x61, 0x63, // 0x4D, 0x69, 0x6E, 0x69, 0x38, 0x2C, 0x31 // 12.0 - 12.3 B1 is MacMini8,1, 12.3 B2+ is Macmini8,1
-};
-
-static const uint8_t kMacModelAirplayExtendedPatched[] = {
-    // iNac17,1 iNac18,1 iNac18,2 iNac18,3
-    // NacBookPro13,1 NacBookPro13,2 NacBookPro13,3 NacBookPro14,1 NacBookPro14,2 NacBookPro14,3
-    // NacMini8,1
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x37, 0x2C, 0x31, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x38, 0x2C, 0x31, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x38, 0x2C, 0x32, 0x00,
-    0x69, 0x4E, 0x61, 0x63, 0x31, 0x38, 0x2C, 0x33, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x33, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x33, 0x2C, 0x32, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x33, 0x2C, 0x33, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x34, 0x2C, 0x31, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x34, 0x2C, 0x32, 0x00,
-    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x34, 0x2C, 0x33, 0x00,
-    0x4E, 0x61, 0x63, // 0x4E, 0x69, 0x6E, 0x69, 0x38, 0x2C, 0x31 // 12.0 - 12.3 B1 is MacMini8,1, 12.3 B2+ is Macmini8,1
-};
+// SidecarCore.framework replaces iPad with hPad, SidecarCore.framework and AirPlaySupport.framework replace Mac with Nac.
+// These model lists are described in Tools/model_patches.spec and generated into kern_model_patch_data.hpp.
 
 static const uint8_t kAirPlayVmmOriginal[] = {
     // p2pAllow kern.hv_vmm_present
@@ -438,60 +128,63 @@ static const uint8_t kNightShiftPatched[] = {
 // - 13.2 Beta 1: 48 8B 05 19 C9 85 32
 // - 13.2.1:      48 8B 05 99 0B 87 32
 // - 13.3 Beta 2: 48 8B 05 A1 E1 44 32
-static const uint8_t kContinuityCameraOriginal[] = {
-    0x55,                                      // push       rbp
-    0x48, 0x89, 0xE5,                          // mov        rbp, rsp
-    0x48, 0x8B, 0x05, 0x00, 0x00, 0x00, 0x00,  // mov        rax, qword [_cpuFamily] (masked)
-    0x8B, 0x0C, 0x07,                          // mov        ecx, dword [rdi+rax]
-    0x31, 0xC0,                                // xor        eax, eax
-    0x81, 0xF9, 0x8B, 0xB7, 0x90, 0x54,        // cmp        ecx, 0x5490b78b
-    0x7E, 0x22                                 // jle        loc_7ff910bfd11e
-};
+static constexpr auto kContinuityCameraPatch = SIGNATURE_PATCH(
+    "55 "                     // push       rbp
+    "48 89 E5 "               // mov        rbp, rsp
+    "48 8B 05 ?? ?? ?? ?? "   // mov        rax, qword [_cpuFamily]
+    "8B 0C 07 "               // mov        ecx, dword [rdi+rax]
+    "31 C0 "                  // xor        eax, eax
+    "81 F9 8B B7 90 54 "      // cmp        ecx, 0x5490b78b
+    "7E 22",                  // jle        loc_7ff910bfd11e
+    // mov eax, 1; ret
+    "B8 01 00 00 00 C3 ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ?? ??");
 
-static const uint8_t kContinuityCameraPatched[] = {
-    0xB8, 0x01, 0x00, 0x00, 0x00,                         // mov       eax 1
-    0xC3,                                                 // ret
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // (padding)
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
-};
+#pragma mark - Verify Patch Size
+
+// Patching the dyld requires that both the find and replace are of same length
+static_assert(sizeof(kAirPlayVmmOriginal) == sizeof(kAirPlayVmmPatched), "patch size invalid");
+static_assert(sizeof(kNightShiftOriginal) == sizeof(kNightShiftPatched), "patch size invalid");
 
-static const uint8_t kContinuityCameraOriginalMask[] = {
-    0xFF,
-    0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00,
-    0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF,
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF, 0xFF
+#pragma mark - Match Anchors
+
+// Rarest bytes of each needle, checked before comparing the whole needle
+static constexpr MatchAnchor kAirPlayVmmAnchor = selectAnchor(kAirPlayVmmOriginal);
+static constexpr MatchAnchor kNightShiftLegacyAnchor = selectAnchor(kNightShiftLegacyOriginal);
+static constexpr MatchAnchor kNightShiftAnchor = selectAnchor(kNightShiftOriginal);
+
+#pragma mark - Skip Tables
+
+// Only needles selectMatchEngine picks for a skip search get a shift table
+static constexpr SkipTable kAirPlayVmmSkip = buildSkipTable(kAirPlayVmmOriginal);
+static constexpr MatchEngine kAirPlayVmmEngine = selectMatchEngine(kAirPlayVmmOriginal);
+static constexpr MatchEngine kNightShiftLegacyEngine = selectMatchEngine(kNightShiftLegacyOriginal);
+static constexpr MatchEngine kNightShiftEngine = selectMatchEngine(kNightShiftOriginal);
+static_assert(kAirPlayVmmEngine == MatchEngine::Horspool, "AirPlay VMM needle engine changed");
+static_assert(kNightShiftLegacyEngine == MatchEngine::Anchor, "NightShift Legacy needle engine changed");
+static_assert(kNightShiftEngine == MatchEngine::Anchor, "NightShift needle engine changed");
+
+#pragma mark - Target Images
+
+// Shared cache images holding the patch sets above, once a cache is mapped only their sections are scanned.
+// A patch set living anywhere else must be listed here, Tools/patch_scan -r reports matches outside of them.
+// Should one be missed, the kext finds it missing from the mapped sections and scans every page again.
+static const char *const kCacheTargetImages[] = {
+    "/SidecarCore.framework/",
+    "/AirPlaySupport.framework/",
+    "/CoreBrightness.framework/",
+    "/AVConference.framework/",
+    "/UniversalControl.framework/"
 };
 
-static const uint8_t kContinuityCameraPatchedMask[] = {
-    0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
-    0xFF,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+static const char *const kCacheTargetSections[] = {
+    "__text",     // Continuity Camera
+    "__cstring",  // model lists, AirPlay VMM check
+    "__const"     // NightShift model families
 };
 
-#pragma mark - Verify Patch Size
+static const CacheTargets kCacheTargets {
+    kCacheTargetImages, sizeof(kCacheTargetImages) / sizeof(kCacheTargetImages[0]),
+    kCacheTargetSections, sizeof(kCacheTargetSections) / sizeof(kCacheTargetSections[0])
+};
 
-// Patching the dyld requires that both the find and replace are of same length
-static_assert(sizeof(kSideCarAirPlayiMacOriginal) == sizeof(kSideCarAirPlayiMacPatched), "patch size invalid");
-static_assert(sizeof(kSideCarAirPlayiMacAlternative2012Original) == sizeof(kSideCarAirPlayiMacAlternative2012Patched), "patch size invalid");
-static_assert(sizeof(kSideCarAirPlayiMacAlternative2013Original) == sizeof(kSideCarAirPlayiMacAlternative2013Patched), "patch size invalid");
-static_assert(sizeof(kSideCarAirPlayiMacAlternative2014Original) == sizeof(kSideCarAirPlayiMacAlternative2014Patched), "patch size invalid");
-static_assert(sizeof(kSideCarAirPlayMacBookOriginal) == sizeof(kSideCarAirPlayMacBookPatched), "patch size invalid");
-static_assert(sizeof(kSideCarAirPlayMacBookMacBookAir2012Original) == sizeof(kSideCarAirPlayMacBooMacBookAir2012Patched), "patch size invalid");
-static_assert(sizeof(kSideCarAirPlayMacBookAir2013_2015Original) == sizeof(kSideCarAirPlayMacBookAir2013_2015Patched), "patch size invalid");
-static_assert(sizeof(kSideCarAirPlayMacBookProOriginal) == sizeof(kSideCarAirPlayMacBookProPatched), "patch size invalid");
-static_assert(sizeof(kSideCarAirPlayMacBookPro2012Original) == sizeof(kSideCarAirPlayMacBookPro2012Patched), "patch size invalid");
-static_assert(sizeof(kSideCarAirPlayMacBookPro2013_2015Original) == sizeof(kSideCarAirPlayMacBookPro2013_2015Patched), "patch size invalid");
-static_assert(sizeof(kSideCarAirPlayStandaloneDesktopOriginal) == sizeof(kSideCarAirPlayStandaloneDesktopPatched), "patch size invalid");
-static_assert(sizeof(kSideCarAirPlayMacProOriginal) == sizeof(kSideCarAirPlayMacProPatched), "patch size invalid");
-static_assert(sizeof(kSideCarAirPlayMacminiOriginal) == sizeof(kSideCarAirPlayMacminiPatched), "patch size invalid");
-static_assert(sizeof(kSidecariPadModelOriginal) == sizeof(kSidecariPadModelPatched), "patch size invalid");
-static_assert(sizeof(kMacModelAirplayExtendedOriginal) == sizeof(kMacModelAirplayExtendedPatched), "patch size invalid");
-static_assert(sizeof(kAirPlayVmmOriginal) == sizeof(kAirPlayVmmPatched), "patch size invalid");
-static_assert(sizeof(kNightShiftOriginal) == sizeof(kNightShiftPatched), "patch size invalid");
-static_assert(sizeof(kContinuityCameraOriginal) == sizeof(kContinuityCameraPatched), "patch size invalid");
-static_assert(sizeof(kContinuityCameraOriginal) == sizeof(kContinuityCameraOriginalMask), "mask size invalid");
-static_assert(sizeof(kContinuityCameraPatched) == sizeof(kContinuityCameraPatchedMask), "mask size invalid");
+#endif /* kern_dyld_patch_hpp */
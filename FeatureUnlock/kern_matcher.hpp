@@ -0,0 +1,610 @@
+//
+//  kern_matcher.hpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+// Multi-pattern page matcher used by the dyld patcher.
+// All patch sets active on the host are registered once at start, afterwards
+// every page is walked a single time regardless of how many patch sets are enabled.
+// Header is intentionally free of Lilu/XNU dependencies.
+
+#ifndef kern_matcher_hpp
+#define kern_matcher_hpp
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+static constexpr size_t kMaxMatchPatterns = 32;
+
+// Bytes kept from each side of a page boundary, patterns longer than this + 1 are not matched across pages
+static constexpr size_t kBoundaryWindow = 160;
+
+// Two bytes of a pattern checked before a full compare
+struct MatchAnchor {
+    uint16_t first;
+    uint16_t second;
+};
+
+// Bytes [begin, end) of a pattern changed by its replacement
+struct MatchSpan {
+    uint16_t begin;
+    uint16_t end;
+};
+
+struct MatchPattern {
+    const uint8_t *find;
+    const uint8_t *findMask;    // nullptr for exact patterns
+    const uint8_t *replace;
+    const uint8_t *replaceMask; // nullptr to replace every byte
+    size_t size;
+    MatchAnchor anchor;
+    MatchSpan diff;             // nothing outside of it is written
+};
+
+#pragma mark - Anchor selection
+
+// Rough frequency of a byte in shared cache pages (code, cstrings and data), lower is rarer
+static constexpr uint8_t anchorByteCost(uint8_t b) {
+    return b == 0x00 ? 100 :
+           b == 0xFF ? 60 :
+           // Common opcodes, REX prefixes and ModRM bytes
+           (b == 0x48 || b == 0x89 || b == 0x8B || b == 0x4C || b == 0xE8 || b == 0x24 || b == 0x01 || b == 0x0F) ? 50 :
+           // Frequent letters and symbol separators
+           (b == 'e' || b == 't' || b == 'a' || b == 'o' || b == 'i' || b == 'n' || b == 's' || b == 'r') ? 40 :
+           (b == '_' || b == '.' || b == ' ' || b == '/') ? 35 :
+           (b >= 'a' && b <= 'z') ? 30 :
+           (b >= 'A' && b <= 'Z') || (b >= '0' && b <= '9') ? 15 :
+           b == ',' ? 5 : 10;
+}
+
+// Picks the two rarest unmasked bytes of a pattern
+static constexpr MatchAnchor selectAnchor(const uint8_t *find, const uint8_t *mask, size_t size) {
+    MatchAnchor best {0, 0};
+    unsigned bestCost = UINT32_MAX;
+    for (size_t i = 0; i < size; i++) {
+        if (mask && mask[i] != 0xFF) {
+            continue;
+        }
+        for (size_t j = i + 1; j < size; j++) {
+            if (mask && mask[j] != 0xFF) {
+                continue;
+            }
+            // The same byte twice rejects less than two distinct ones
+            unsigned cost = anchorByteCost(find[i]) + anchorByteCost(find[j]) + (find[i] == find[j] ? 5 : 0);
+            if (cost < bestCost) {
+                bestCost = cost;
+                best = {static_cast<uint16_t>(i), static_cast<uint16_t>(j)};
+            }
+        }
+    }
+    return best;
+}
+
+template <size_t N>
+static constexpr MatchAnchor selectAnchor(const uint8_t (&find)[N]) {
+    return selectAnchor(find, nullptr, N);
+}
+
+template <size_t N, size_t M>
+static constexpr MatchAnchor selectAnchor(const uint8_t (&find)[N], const uint8_t (&mask)[M]) {
+    static_assert(N == M, "mask size invalid");
+    return selectAnchor(find, mask, N);
+}
+
+#pragma mark - Diff span
+
+// Smallest span holding every byte the replacement changes, masked replacement bytes keep the original
+static constexpr MatchSpan diffSpan(const uint8_t *find, const uint8_t *findMask, const uint8_t *replace, const uint8_t *replaceMask, size_t size) {
+    MatchSpan span {0, 0};
+    bool found = false;
+    for (size_t i = 0; i < size; i++) {
+        uint8_t written = replaceMask ? replaceMask[i] : 0xFF;
+        bool fixed = !findMask || findMask[i] == 0xFF;
+        if (written != 0 && (!fixed || ((find[i] ^ replace[i]) & written) != 0)) {
+            if (!found) {
+                span.begin = static_cast<uint16_t>(i);
+                found = true;
+            }
+            span.end = static_cast<uint16_t>(i + 1);
+        }
+    }
+    return span;
+}
+
+template <size_t N>
+static constexpr MatchSpan diffSpan(const uint8_t (&find)[N], const uint8_t (&replace)[N]) {
+    return diffSpan(find, nullptr, replace, nullptr, N);
+}
+
+#pragma mark - Word at a time helpers
+
+/*
+Kernel code must not touch vector registers without saving the user FPU state,
+thus the prefilter works on 64-bit general purpose registers (SWAR) instead of SSE/AVX.
+*/
+
+static inline uint64_t loadWord(const uint8_t *data) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+// Sets the high bit of every byte of word equal to value, exact with no false positives
+static inline uint64_t matchByte(uint64_t word, uint8_t value) {
+    constexpr uint64_t low7 = 0x7F7F7F7F7F7F7F7FULL;
+    uint64_t x = word ^ (0x0101010101010101ULL * value);
+    return ~(((x & low7) + low7) | x | low7);
+}
+
+// Whether any position of the buffer holds both anchor bytes of the pattern
+static inline bool hasAnchorCandidate(const uint8_t *data, size_t size, const uint8_t *find, size_t findSize, MatchAnchor anchor) {
+    if (size < findSize) {
+        return false;
+    }
+    size_t last = size - findSize;
+    uint8_t first = find[anchor.first];
+    uint8_t second = find[anchor.second];
+    size_t i = 0;
+    for (; i + 8 <= last + 1; i += 8) {
+        if (matchByte(loadWord(&data[i + anchor.first]), first) & matchByte(loadWord(&data[i + anchor.second]), second)) {
+            return true;
+        }
+    }
+    for (; i <= last; i++) {
+        if (data[i + anchor.first] == first && data[i + anchor.second] == second) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#pragma mark - Pattern helpers
+
+// Checks a slice [from, from + length) of the pattern against data, masked bytes match anything
+static inline bool matchPattern(const uint8_t *data, const MatchPattern &pattern, size_t from, size_t length) {
+    if (!pattern.findMask) {
+        return memcmp(data, pattern.find + from, length) == 0;
+    }
+    // Masked patterns are compared a word at a time, the mask clears the bytes that differ between builds
+    const uint8_t *find = pattern.find + from;
+    const uint8_t *mask = pattern.findMask + from;
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        if (((loadWord(&data[i]) ^ loadWord(&find[i])) & loadWord(&mask[i])) != 0) {
+            return false;
+        }
+    }
+    for (; i < length; i++) {
+        if (((data[i] ^ find[i]) & mask[i]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Overwrites a slice [from, from + length) of the pattern with its replacement, within its diff span
+static inline void applyPattern(uint8_t *data, const MatchPattern &pattern, size_t from, size_t length) {
+    size_t begin = from > pattern.diff.begin ? from : pattern.diff.begin;
+    size_t end = from + length < pattern.diff.end ? from + length : pattern.diff.end;
+    if (begin >= end) {
+        return;
+    }
+    data += begin - from;
+    if (!pattern.replaceMask) {
+        memcpy(data, pattern.replace + begin, end - begin);
+        return;
+    }
+    for (size_t i = begin; i < end; i++) {
+        data[i - begin] = (data[i - begin] & ~pattern.replaceMask[i]) | (pattern.replace[i] & pattern.replaceMask[i]);
+    }
+}
+
+// Offset of the first match at or after from, SIZE_MAX when there is none
+static inline size_t findPattern(const uint8_t *data, size_t size, size_t from, const MatchPattern &pattern) {
+    uint8_t first = pattern.find[pattern.anchor.first];
+    uint8_t second = pattern.find[pattern.anchor.second];
+    for (size_t i = from; pattern.size <= size && i <= size - pattern.size; i++) {
+        if (data[i + pattern.anchor.first] == first && data[i + pattern.anchor.second] == second &&
+            matchPattern(&data[i], pattern, 0, pattern.size)) {
+            return i;
+        }
+    }
+    return SIZE_MAX;
+}
+
+#pragma mark - Skip search
+
+// Horspool shift table of a pattern, built at compile time next to the pattern.
+// The probe is not necessarily the last byte: a pattern ending with zeroes would barely skip
+// over zero filled pages, hence the probe maximising the skips over likely bytes is used.
+struct SkipTable {
+    uint16_t shift[256];
+    uint16_t probe;
+    uint16_t zeroRun;  // longest run of pattern bytes that may be zero
+};
+
+// Skip for every byte seen at the probe position, masked bytes match anything and bound all skips
+static constexpr void buildSkipShifts(const uint8_t *find, const uint8_t *mask, size_t position, uint16_t (&shift)[256]) {
+    size_t wildcard = 0;
+    for (size_t i = 0; i < position; i++) {
+        if (mask && mask[i] != 0xFF) {
+            wildcard = i + 1;
+        }
+    }
+    for (size_t b = 0; b < 256; b++) {
+        shift[b] = static_cast<uint16_t>(position + 1 - wildcard);
+    }
+    for (size_t i = wildcard; i < position; i++) {
+        shift[find[i]] = static_cast<uint16_t>(position - i);
+    }
+}
+
+static constexpr SkipTable buildSkipTable(const uint8_t *find, const uint8_t *mask, size_t size) {
+    SkipTable table {};
+    // Expected skip weighted by anchorByteCost, which grows with the byte frequency
+    uint64_t bestScore = 0;
+    for (size_t position = size / 2; position < size; position++) {
+        if (mask && mask[position] != 0xFF) {
+            continue;
+        }
+        buildSkipShifts(find, mask, position, table.shift);
+        uint64_t score = 0;
+        for (size_t b = 0; b < 256; b++) {
+            score += static_cast<uint64_t>(anchorByteCost(static_cast<uint8_t>(b))) * table.shift[b];
+        }
+        if (score >= bestScore) {
+            bestScore = score;
+            table.probe = static_cast<uint16_t>(position);
+        }
+    }
+    buildSkipShifts(find, mask, table.probe, table.shift);
+    size_t run = 0;
+    for (size_t i = 0; i < size; i++) {
+        run = (find[i] & (mask ? mask[i] : 0xFF)) == 0 ? run + 1 : 0;
+        if (run > table.zeroRun) {
+            table.zeroRun = static_cast<uint16_t>(run);
+        }
+    }
+    return table;
+}
+
+template <size_t N>
+static constexpr SkipTable buildSkipTable(const uint8_t (&find)[N]) {
+    return buildSkipTable(find, nullptr, N);
+}
+
+// Horspool search of a pattern probing one byte per window
+class SkipSearch {
+    const MatchPattern &pattern;
+    const SkipTable &table;
+
+    // Window following one whose probe landed on 8 zero bytes at position.
+    // No match holds a zero run longer than the pattern's own, nor ends in one when probing
+    // close enough to the start, so the windows overlapping a long zero run are skipped at once.
+    __attribute__((noinline)) size_t skipZeroRun(const uint8_t *data, size_t dataSize, size_t position, size_t next) const {
+        size_t end = position + 8;
+        while (end + 8 <= dataSize && loadWord(&data[end]) == 0) {
+            end += 8;
+        }
+        while (end < dataSize && data[end] == 0) {
+            end++;
+        }
+        return end - position > table.zeroRun && end - table.zeroRun > next ? end - table.zeroRun : next;
+    }
+
+public:
+    SkipSearch(const MatchPattern &pattern, const SkipTable &table) : pattern(pattern), table(table) {}
+
+    // Offset of the first match at or after from, SIZE_MAX when there is none
+    size_t search(const uint8_t *data, size_t dataSize, size_t from = 0) const {
+        const size_t size = pattern.size;
+        const size_t probe = table.probe;
+        const uint8_t expected = pattern.find[probe];
+        // Zero bytes at the probe are common in code and cstrings, only several in a row hint at padding
+        const size_t zeroProbes = probe + table.zeroRun <= size ? 2 : SIZE_MAX;
+        size_t zeros = 0;
+        for (size_t i = from; size <= dataSize && i <= dataSize - size; ) {
+            uint8_t b = data[i + probe];
+            size_t next = i + table.shift[b];
+            zeros = b == 0 ? zeros + 1 : 0;
+            if (__builtin_expect((b == expected) | (zeros >= zeroProbes), 0)) {
+                if (b == expected && matchPattern(&data[i], pattern, 0, size)) {
+                    return i;
+                }
+                if (zeros >= zeroProbes && i + probe + 8 <= dataSize && loadWord(&data[i + probe]) == 0) {
+                    next = skipZeroRun(data, dataSize, i + probe, next);
+                }
+            }
+            i = next;
+        }
+        return SIZE_MAX;
+    }
+};
+
+#pragma mark - Engine selection
+
+/*
+Single patterns (binary targets, long dyld patterns) are searched by the engine best suited
+to their bytes, as measured over code, cstring, zero and hit pages by Tools/matcher_bench.cpp.
+The anchor prefilter visits every position, a skip search is faster as soon as its expected
+skip passes the measured crossover, provided zero filled pages do not stall it: probes landing
+on zeroes must either skip far or lead to the zero run skip.
+*/
+
+enum class MatchEngine : uint8_t {
+    Anchor,    // SWAR anchor byte prefilter
+    Horspool,  // Horspool skip search
+};
+
+// Smallest expected skip measured faster than the anchor prefilter (Sidecar/AirPlay Mac Pro, Control Center),
+// 1.5 to 2x on reject pages over 15 runs. No needle clear of zero page stalls was measured faster with the anchor
+// prefilter above it: AirPlay VMM (expected skip 25) rejects pages within 10% either way from run to run, at a
+// median 1.2x for the skip search, and is faster with the skip search on hit pages in every run.
+static constexpr size_t kHorspoolMinSkip = 17;
+
+// Mean skip over likely bytes, weighted by anchorByteCost as when choosing the probe
+static constexpr size_t expectedSkip(const SkipTable &table) {
+    uint64_t weighted = 0;
+    uint64_t total = 0;
+    for (size_t b = 0; b < 256; b++) {
+        weighted += static_cast<uint64_t>(anchorByteCost(static_cast<uint8_t>(b))) * table.shift[b];
+        total += anchorByteCost(static_cast<uint8_t>(b));
+    }
+    return static_cast<size_t>(weighted / total);
+}
+
+static constexpr MatchEngine selectMatchEngine(const SkipTable &table, size_t size) {
+    bool zeroPages = table.probe + table.zeroRun <= size || table.shift[0] >= kHorspoolMinSkip;
+    return zeroPages && expectedSkip(table) >= kHorspoolMinSkip ? MatchEngine::Horspool : MatchEngine::Anchor;
+}
+
+template <size_t N>
+static constexpr MatchEngine selectMatchEngine(const uint8_t (&find)[N]) {
+    return selectMatchEngine(buildSkipTable(find), N);
+}
+
+#pragma mark - Multi pattern matcher
+
+class MultiPatternMatcher {
+    // Bit N is set when pattern N may start with the byte used as index
+    uint32_t firstByte[256] {};
+    MatchPattern patterns[kMaxMatchPatterns] {};
+    size_t count {0};
+    size_t minSize {SIZE_MAX};
+    size_t maxSize {0};
+    // Patterns short enough to be matched across a page boundary
+    uint32_t boundaryPatterns {0};
+    // Bit N is set when the byte used as index is the first anchor byte of pattern N
+    uint32_t anchorByte[256] {};
+
+    static inline bool verify(const uint8_t *data, const MatchPattern &pattern) {
+        return matchPattern(data, pattern, 0, pattern.size);
+    }
+
+    // Walks the buffer once, match(index, offset) is called for every non-overlapping match of each enabled pattern
+    // Returns the bitmask of patterns whose anchor bytes were found whether the full pattern matched or not
+    template <typename F>
+    uint32_t walk(const uint8_t *data, size_t size, uint32_t enabled, F &&match) const {
+        uint32_t anchored = 0;
+        if (count == 0 || enabled == 0 || size < minSize) {
+            return anchored;
+        }
+
+        // Distinct first anchor bytes of the enabled patterns, several patterns usually share one
+        uint8_t bytes[kMaxMatchPatterns];
+        size_t byteCount = 0;
+        bool zeroAnchor = false;
+        for (uint32_t pending = enabled; pending != 0; pending &= pending - 1) {
+            const MatchPattern &p = patterns[__builtin_ctz(pending)];
+            uint8_t b = p.find[p.anchor.first];
+            zeroAnchor |= b == 0;
+            size_t k = 0;
+            while (k < byteCount && bytes[k] != b) {
+                k++;
+            }
+            if (k == byteCount) {
+                bytes[byteCount++] = b;
+            }
+        }
+
+        size_t next[kMaxMatchPatterns] {};
+        auto tryAnchor = [&](size_t position) {
+            uint32_t candidates = anchorByte[data[position]] & enabled;
+            while (candidates != 0) {
+                size_t index = __builtin_ctz(candidates);
+                candidates &= candidates - 1;
+                const MatchPattern &p = patterns[index];
+                if (position < p.anchor.first) {
+                    continue;
+                }
+                size_t offset = position - p.anchor.first;
+                if (p.size > size - offset || data[offset + p.anchor.second] != p.find[p.anchor.second]) {
+                    continue;
+                }
+                anchored |= 1U << index;
+                if (offset < next[index] || !verify(&data[offset], p)) {
+                    continue;
+                }
+                match(index, offset);
+                next[index] = offset + p.size;
+            }
+        };
+
+        auto anchorHits = [&](uint64_t word) {
+            uint64_t hits = 0;
+            for (size_t k = 0; k < byteCount; k++) {
+                hits |= matchByte(word, bytes[k]);
+            }
+            return hits;
+        };
+        auto tryHits = [&](size_t position, uint64_t hits) {
+            while (__builtin_expect(hits != 0, 0)) {
+                tryAnchor(position + __builtin_ctzll(hits) / 8);
+                hits &= hits - 1;
+            }
+        };
+
+        // Anchor bytes are looked for 32 positions at a time in four independent words, only the
+        // positions holding one of them go through the dispatch table and the second anchor check
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            uint64_t w0 = loadWord(&data[i]);
+            uint64_t w1 = loadWord(&data[i + 8]);
+            uint64_t w2 = loadWord(&data[i + 16]);
+            uint64_t w3 = loadWord(&data[i + 24]);
+            // Anchors are rarely zero bytes, padding and bss pages are skipped right away
+            if ((w0 | w1 | w2 | w3) == 0 && !zeroAnchor) {
+                continue;
+            }
+            uint64_t h0 = anchorHits(w0);
+            uint64_t h1 = anchorHits(w1);
+            uint64_t h2 = anchorHits(w2);
+            uint64_t h3 = anchorHits(w3);
+            if (__builtin_expect((h0 | h1 | h2 | h3) == 0, 1)) {
+                continue;
+            }
+            tryHits(i, h0);
+            tryHits(i + 8, h1);
+            tryHits(i + 16, h2);
+            tryHits(i + 24, h3);
+        }
+        for (; i + 8 <= size; i += 8) {
+            uint64_t word = loadWord(&data[i]);
+            if (word != 0 || zeroAnchor) {
+                tryHits(i, anchorHits(word));
+            }
+        }
+        for (; i < size; i++) {
+            tryAnchor(i);
+        }
+        return anchored;
+    }
+
+public:
+    // Returns index of the added pattern or -1 when the matcher is full
+    int add(const MatchPattern &pattern) {
+        if (count == kMaxMatchPatterns || pattern.size == 0 || pattern.anchor.first >= pattern.size || pattern.anchor.second >= pattern.size) {
+            return -1;
+        }
+        uint8_t mask = pattern.findMask ? pattern.findMask[0] : 0xFF;
+        for (size_t b = 0; b < 256; b++) {
+            if ((b & mask) == (pattern.find[0] & mask)) {
+                firstByte[b] |= 1U << count;
+            }
+        }
+        patterns[count] = pattern;
+        if (pattern.size < minSize) {
+            minSize = pattern.size;
+        }
+        if (pattern.size > maxSize) {
+            maxSize = pattern.size;
+        }
+        anchorByte[pattern.find[pattern.anchor.first]] |= 1U << count;
+        if (pattern.size > 1 && pattern.size - 1 <= kBoundaryWindow) {
+            boundaryPatterns |= 1U << count;
+        }
+        return static_cast<int>(count++);
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    const MatchPattern &pattern(size_t index) const {
+        return patterns[index];
+    }
+
+    // Number of bytes to keep from each side of a page to find matches crossing it
+    size_t boundarySize() const {
+        return maxSize > kBoundaryWindow + 1 ? kBoundaryWindow : (maxSize > 0 ? maxSize - 1 : 0);
+    }
+
+    // Checks a slice [from, from + length) of the pattern against data
+    bool verify(const uint8_t *data, size_t index, size_t from, size_t length) const {
+        return matchPattern(data, patterns[index], from, length);
+    }
+
+    // Overwrites a slice [from, from + length) of the pattern with its replacement
+    void apply(uint8_t *data, size_t index, size_t from, size_t length) const {
+        applyPattern(data, patterns[index], from, length);
+    }
+
+    // Overwrites the matched bytes with the pattern replacement
+    void apply(uint8_t *data, size_t index) const {
+        apply(data, index, 0, patterns[index].size);
+    }
+
+    // Walks the buffer once, patching every non-overlapping match of each enabled pattern
+    // Returns the bitmask of patterns applied at least once, candidates receives the bitmask
+    // of patterns whose anchor bytes were found whether the full pattern matched or not
+    uint32_t scanAndPatch(uint8_t *data, size_t size, uint32_t enabled, uint32_t *candidates = nullptr) const {
+        return scanAndPatch(data, size, enabled, candidates, [](size_t, size_t) {});
+    }
+
+    // Same as above, patched(index, offset) is called for every applied match
+    template <typename F>
+    uint32_t scanAndPatch(uint8_t *data, size_t size, uint32_t enabled, uint32_t *candidates, F &&patched) const {
+        uint32_t applied = 0;
+        uint32_t anchored = walk(data, size, enabled, [&](size_t index, size_t offset) {
+            apply(&data[offset], index);
+            applied |= 1U << index;
+            patched(index, offset);
+        });
+        if (candidates) {
+            *candidates = anchored;
+        }
+        return applied;
+    }
+
+    // Same walk as scanAndPatch without modifying the buffer, found(index, offset) is called for every match
+    // Returns the bitmask of patterns found at least once
+    template <typename F>
+    uint32_t scan(const uint8_t *data, size_t size, uint32_t enabled, F &&found) const {
+        uint32_t matched = 0;
+        walk(data, size, enabled, [&](size_t index, size_t offset) {
+            found(index, offset);
+            matched |= 1U << index;
+        });
+        return matched;
+    }
+
+    // Finds matches starting in tail (end of the first buffer) and ending in head (start of the second one)
+    // found(index, split) is called with the number of pattern bytes located in the tail.
+    // Either buffer may have been handed out already, such a match is complete only once both are patched.
+    template <typename F>
+    void scanBoundary(const uint8_t *tail, size_t tailSize, const uint8_t *head, size_t headSize, uint32_t enabled, F &&found) const {
+        enabled &= boundaryPatterns;
+        if (enabled == 0 || tailSize == 0 || headSize == 0) {
+            return;
+        }
+        if (tailSize > kBoundaryWindow) {
+            tail += tailSize - kBoundaryWindow;
+            tailSize = kBoundaryWindow;
+        }
+        if (headSize > kBoundaryWindow) {
+            headSize = kBoundaryWindow;
+        }
+        uint8_t window[kBoundaryWindow * 2];
+        memcpy(window, tail, tailSize);
+        memcpy(window + tailSize, head, headSize);
+        size_t windowSize = tailSize + headSize;
+        for (size_t i = 0; i < tailSize; i++) {
+            uint32_t candidates = firstByte[window[i]] & enabled;
+            while (__builtin_expect(candidates != 0, 0)) {
+                size_t index = __builtin_ctz(candidates);
+                candidates &= candidates - 1;
+                const MatchPattern &p = patterns[index];
+                // Only matches actually crossing into head are of interest
+                if (i + p.size <= tailSize || i + p.size > windowSize || !verify(&window[i], p)) {
+                    continue;
+                }
+                found(index, tailSize - i);
+            }
+        }
+    }
+};
+
+#endif /* kern_matcher_hpp */
@@ -5,136 +5,241 @@
 //  Copyright © 2022 Mykola Grymalyuk. All rights reserved.
 //
 
-
-#pragma mark - MacBooks
-
-static char *macbook_legacy_models[] = {
-    (char *)"MacBook4,1",
-    (char *)"MacBook5,1", (char *)"MacBook5,2",
-    (char *)"MacBook6,1",
-    (char *)"MacBook7,1"
-};
-
-static char *macbook_modern_models[] = {
-    (char *)"MacBook8,1"
-};
-
-#pragma mark - MacBook Airs
-
-static char *macbookair_legacy_models[] = {
-    (char *)"MacBookAir2,1",
-    (char *)"MacBookAir3,1", (char *)"MacBookAir3,2",
-    (char *)"MacBookAir4,1", (char *)"MacBookAir4,2"
-};
-
-static char *macbookair_2012_models[] = {
-    (char *)"MacBookAir5,1", (char *)"MacBookAir5,2"
-};
-
-static char *macbookair_2013_models[] = {
-    (char *)"MacBookAir6,1", (char *)"MacBookAir6,2"
-};
-
-static char *macbookair_2015_models[] = {
-    (char *)"MacBookAir7,1", (char *)"MacBookAir7,2"
-};
-
-#pragma mark - MacBook Pros
-
-static char *macbookpro_legacy_models[] = {
-    (char *)"MacBookPro4,1",
-    (char *)"MacBookPro5,1", (char *)"MacBookPro5,2", (char *)"MacBookPro5,3", (char *)"MacBookPro5,4", (char *)"MacBookPro5,5",
-    (char *)"MacBookPro6,1", (char *)"MacBookPro6,2",
-    (char *)"MacBookPro7,1",
-    (char *)"MacBookPro8,1", (char *)"MacBookPro8,2", (char *)"MacBookPro8,3"
-};
-
-static char *macbookpro_2012_models[] = {
-    (char *)"MacBookPro9,1", (char *)"MacBookPro9,2",
-    (char *)"MacBookPro10,1", (char *)"MacBookPro10,2"
-};
-
-static char *macbookpro_2013_models[] = {
-    (char *)"MacBookPro11,1", (char *)"MacBookPro11,2", (char *)"MacBookPro11,3"
-};
-
-static char *macbookpro_2015_models[] = {
-    (char *)"MacBookPro11,4", (char *)"MacBookPro11,5",
-    (char *)"MacBookPro12,1"
-};
-
-static char *macbookpro_2016_models[] = {
-    (char *)"MacBookPro13,1", (char *)"MacBookPro13,2", (char *)"MacBookPro13,3"
-};
-
-static char *macbookpro_2017_models[] = {
-    (char *)"MacBookPro14,1", (char *)"MacBookPro14,2", (char *)"MacBookPro14,3"
-};
-
-#pragma mark - iMacs
-
-static char *imac_legacy_models[] = {
-    (char *)"iMac7,1",
-    (char *)"iMac8,1",
-    (char *)"iMac9,1",
-    (char *)"iMac10,1",
-    (char *)"iMac11,1", (char *)"iMac11,2", (char *)"iMac11,3",
-    (char *)"iMac12,1", (char *)"iMac12,2",
-};
-
-static char *imac_2012_models[] = {
-    (char *)"iMac13,1", (char *)"iMac13,2", (char *)"iMac13,3"
-};
-
-static char *imac_2013_models[] = {
-    (char *)"iMac14,1", (char *)"iMac14,2", (char *)"iMac14,3", (char *)"iMac14,4"
-};
-
-static char *imac_2014_models[] = {
-    (char *)"iMac15,1"
-};
-
-static char *imac_2015_broadwell_models[] = {
-    (char *)"iMac16,1", (char *)"iMac16,2"
-};
-
-static char *imac_2015_2017_models[] = {
-    (char *)"iMac17,1",
-    (char *)"iMac18,1", (char *)"iMac18,2", (char *)"iMac18,3"
-};
-
-#pragma mark - Mac Pros
-
-static char *macpro_legacy_models[] = {
-    (char *)"MacPro3,1",
-    (char *)"MacPro4,1",
-    (char *)"MacPro5,1"
-};
-
-static char *macpro_2010_2012_models[] = {
-    (char *)"MacPro5,1",
-};
-
-static char *macpro_2013_models[] = {
-    (char *)"MacPro6,1"
-};
-
-#pragma mark - Mac minis
-
-static char *macmini_legacy_models[] = {
-    (char *)"Macmini3,1",
-    (char *)"Macmini4,1",
-    (char *)"Macmini5,1", (char *)"Macmini5,2", (char *)"Macmini5,3",
-};
-
-static char *macmini_2012_models[] = {
-    (char *)"Macmini6,1", (char *)"Macmini6,2",
-};
-
-static char *macmini_2014_models[] = {
-    (char *)"Macmini7,1"
-};
-
-static char *macmini_2018_models[] = {
-    (char *)"Macmini8,1"
-};
+#ifndef kern_model_info_hpp
+#define kern_model_info_hpp
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#pragma mark - Model Classes
+
+// Model family detected, one bit each so that patch sets can target several of them
+enum ModelClass : uint32_t {
+    ModelUnknown               = 0,
+    ModeliMacPre2012           = 1U << 0,   // iMac7,1 - iMac12,x
+    ModeliMac2012              = 1U << 1,   // iMac13,x
+    ModeliMac2013              = 1U << 2,   // iMac14,x
+    ModeliMac2014              = 1U << 3,   // iMac15,1
+    ModeliMac2015Broadwell     = 1U << 4,   // iMac16,x
+    ModeliMac2015_2017         = 1U << 5,   // iMac17,x - iMac18,x
+
+    ModelMacBookPre2015        = 1U << 6,   // MacBook4,1 - MacBook7,1
+    ModelMacBook2015           = 1U << 7,   // MacBook8,1
+
+    ModelMacBookAirPre2012     = 1U << 8,   // MacBookAir2,1 - MacBookAir4,x
+    ModelMacBookAir2012        = 1U << 9,   // MacBookAir5,x
+    ModelMacBookAir2013        = 1U << 10,  // MacBookAir6,x
+    ModelMacBookAir2015        = 1U << 11,  // MacBookAir7,x
+
+    ModelMacBookProPre2012     = 1U << 12,  // MacBookPro4,1 - MacBookPro8,x
+    ModelMacBookPro2012        = 1U << 13,  // MacBookPro9,x - MacBookPro10,x
+    ModelMacBookPro2013        = 1U << 14,  // MacBookPro11,1 - 3
+    ModelMacBookPro2015        = 1U << 15,  // MacBookPro11,4 - 5 - MacBookPro12,1
+    ModelMacBookPro2016        = 1U << 16,  // MacBookPro13,x
+    ModelMacBookPro2017        = 1U << 17,  // MacBookPro14,x
+
+    ModelMacminiPre2012        = 1U << 18,  // Macmini3,1 - Macmini5,x
+    ModelMacmini2012           = 1U << 19,  // Macmini6,x
+    ModelMacmini2014           = 1U << 20,  // Macmini7,x
+    ModelMacmini2018           = 1U << 21,  // Macmini8,x
+
+    ModelMacProPre2010         = 1U << 22,  // MacPro3,1 - MacPro4,1
+    ModelMacPro2010_2012       = 1U << 23,  // MacPro5,x
+    ModelMacPro2013            = 1U << 24,  // MacPro6,x
+};
+
+
+#pragma mark - Model Ranges
+
+enum class ModelFamily : uint8_t {
+    Unknown,
+    iMac,
+    MacBook,
+    MacBookAir,
+    MacBookPro,
+    Macmini,
+    MacPro,
+    Count
+};
+
+// Model identifiers family<major>,<minor> sharing a model class
+struct ModelRange {
+    ModelFamily family;
+    uint8_t major;
+    uint8_t minorFirst;
+    uint8_t minorLast;
+    ModelClass cls;
+    const char *name;
+};
+
+static constexpr ModelRange kModelRanges[] {
+    // MacBooks
+    {ModelFamily::MacBook, 4, 1, 1, ModelMacBookPre2015, "legacy MacBook"},
+    {ModelFamily::MacBook, 5, 1, 2, ModelMacBookPre2015, "legacy MacBook"},
+    {ModelFamily::MacBook, 6, 1, 1, ModelMacBookPre2015, "legacy MacBook"},
+    {ModelFamily::MacBook, 7, 1, 1, ModelMacBookPre2015, "legacy MacBook"},
+    {ModelFamily::MacBook, 8, 1, 1, ModelMacBook2015, "MacBook 2015"},
+
+    // MacBook Airs
+    {ModelFamily::MacBookAir, 2, 1, 1, ModelMacBookAirPre2012, "legacy MacBookAir"},
+    {ModelFamily::MacBookAir, 3, 1, 2, ModelMacBookAirPre2012, "legacy MacBookAir"},
+    {ModelFamily::MacBookAir, 4, 1, 2, ModelMacBookAirPre2012, "legacy MacBookAir"},
+    {ModelFamily::MacBookAir, 5, 1, 2, ModelMacBookAir2012, "MacBookAir 2012"},
+    {ModelFamily::MacBookAir, 6, 1, 2, ModelMacBookAir2013, "MacBookAir 2013"},
+    {ModelFamily::MacBookAir, 7, 1, 2, ModelMacBookAir2015, "MacBookAir 2015"},
+
+    // MacBook Pros
+    {ModelFamily::MacBookPro, 4, 1, 1, ModelMacBookProPre2012, "legacy MacBookPro"},
+    {ModelFamily::MacBookPro, 5, 1, 5, ModelMacBookProPre2012, "legacy MacBookPro"},
+    {ModelFamily::MacBookPro, 6, 1, 2, ModelMacBookProPre2012, "legacy MacBookPro"},
+    {ModelFamily::MacBookPro, 7, 1, 1, ModelMacBookProPre2012, "legacy MacBookPro"},
+    {ModelFamily::MacBookPro, 8, 1, 3, ModelMacBookProPre2012, "legacy MacBookPro"},
+    {ModelFamily::MacBookPro, 9, 1, 2, ModelMacBookPro2012, "MacBookPro 2012"},
+    {ModelFamily::MacBookPro, 10, 1, 2, ModelMacBookPro2012, "MacBookPro 2012"},
+    {ModelFamily::MacBookPro, 11, 1, 3, ModelMacBookPro2013, "MacBookPro 2013"},
+    {ModelFamily::MacBookPro, 11, 4, 5, ModelMacBookPro2015, "MacBookPro 2015"},
+    {ModelFamily::MacBookPro, 12, 1, 1, ModelMacBookPro2015, "MacBookPro 2015"},
+    {ModelFamily::MacBookPro, 13, 1, 3, ModelMacBookPro2016, "MacBookPro 2016"},
+    {ModelFamily::MacBookPro, 14, 1, 3, ModelMacBookPro2017, "MacBookPro 2017"},
+
+    // iMacs
+    {ModelFamily::iMac, 7, 1, 1, ModeliMacPre2012, "legacy iMac"},
+    {ModelFamily::iMac, 8, 1, 1, ModeliMacPre2012, "legacy iMac"},
+    {ModelFamily::iMac, 9, 1, 1, ModeliMacPre2012, "legacy iMac"},
+    {ModelFamily::iMac, 10, 1, 1, ModeliMacPre2012, "legacy iMac"},
+    {ModelFamily::iMac, 11, 1, 3, ModeliMacPre2012, "legacy iMac"},
+    {ModelFamily::iMac, 12, 1, 2, ModeliMacPre2012, "legacy iMac"},
+    {ModelFamily::iMac, 13, 1, 3, ModeliMac2012, "iMac 2012"},
+    {ModelFamily::iMac, 14, 1, 4, ModeliMac2013, "iMac 2013"},
+    {ModelFamily::iMac, 15, 1, 1, ModeliMac2014, "iMac 2014"},
+    {ModelFamily::iMac, 16, 1, 2, ModeliMac2015Broadwell, "iMac 2015 Broadwell"},
+    {ModelFamily::iMac, 17, 1, 1, ModeliMac2015_2017, "iMac 2015-2017"},
+    {ModelFamily::iMac, 18, 1, 3, ModeliMac2015_2017, "iMac 2015-2017"},
+
+    // Mac Pros
+    {ModelFamily::MacPro, 3, 1, 1, ModelMacProPre2010, "legacy Mac Pro"},
+    {ModelFamily::MacPro, 4, 1, 1, ModelMacProPre2010, "legacy Mac Pro"},
+    {ModelFamily::MacPro, 5, 1, 1, ModelMacPro2010_2012, "Mac Pro 2010-2012"},
+    {ModelFamily::MacPro, 6, 1, 1, ModelMacPro2013, "Mac Pro 2013"},
+
+    // Mac minis
+    {ModelFamily::Macmini, 3, 1, 1, ModelMacminiPre2012, "legacy Mac mini"},
+    {ModelFamily::Macmini, 4, 1, 1, ModelMacminiPre2012, "legacy Mac mini"},
+    {ModelFamily::Macmini, 5, 1, 3, ModelMacminiPre2012, "legacy Mac mini"},
+    {ModelFamily::Macmini, 6, 1, 2, ModelMacmini2012, "Mac mini 2012"},
+    {ModelFamily::Macmini, 7, 1, 1, ModelMacmini2014, "Mac mini 2014"},
+    {ModelFamily::Macmini, 8, 1, 1, ModelMacmini2018, "Mac mini 2018"},
+};
+
+#pragma mark - Model Lookup
+
+static constexpr size_t kModelRangeCount = sizeof(kModelRanges) / sizeof(kModelRanges[0]);
+static constexpr size_t kModelMaxMajor = 32;
+static constexpr size_t kModelRangesPerMajor = 2;
+
+// Indices + 1 into kModelRanges for every family and major, 0 when unused
+struct ModelLookup {
+    uint8_t ranges[static_cast<size_t>(ModelFamily::Count)][kModelMaxMajor][kModelRangesPerMajor];
+    bool valid;
+};
+
+static constexpr ModelLookup buildModelLookup() {
+    ModelLookup lookup {};
+    lookup.valid = kModelRangeCount < UINT8_MAX;
+    for (size_t i = 0; i < kModelRangeCount; i++) {
+        const ModelRange &range = kModelRanges[i];
+        // Only the first minor digit is parsed
+        if (range.major >= kModelMaxMajor || range.minorFirst > range.minorLast || range.minorLast > 9) {
+            lookup.valid = false;
+            continue;
+        }
+        auto &slots = lookup.ranges[static_cast<size_t>(range.family)][range.major];
+        size_t slot = 0;
+        while (slot < kModelRangesPerMajor && slots[slot] != 0) {
+            slot++;
+        }
+        if (slot == kModelRangesPerMajor) {
+            lookup.valid = false;
+            continue;
+        }
+        slots[slot] = static_cast<uint8_t>(i + 1);
+    }
+    return lookup;
+}
+
+static constexpr ModelLookup kModelLookup = buildModelLookup();
+static_assert(kModelLookup.valid, "model ranges do not fit the lookup table");
+
+struct ModelIdentifier {
+    ModelFamily family;
+    uint32_t major;
+    uint32_t minor;
+};
+
+// Parses family<major>,<minor> in a single pass, anything past the first minor digit is ignored.
+// Sometimes the model can have garbage on the end, ex. MacBookPro13,1DvcPtsupre, identifiers were
+// matched as prefixes so far, hence iMac7,10 is still taken for iMac7,1.
+static inline bool parseModelIdentifier(const char *identifier, ModelIdentifier &model) {
+    const char *p = identifier;
+    model = {ModelFamily::Unknown, 0, 0};
+    if (strncmp(p, "iMac", sizeof("iMac") - 1) == 0) {
+        model.family = ModelFamily::iMac;
+        p += sizeof("iMac") - 1;
+    } else if (strncmp(p, "Mac", sizeof("Mac") - 1) == 0) {
+        p += sizeof("Mac") - 1;
+        if (strncmp(p, "Book", sizeof("Book") - 1) == 0) {
+            p += sizeof("Book") - 1;
+            if (strncmp(p, "Pro", sizeof("Pro") - 1) == 0) {
+                model.family = ModelFamily::MacBookPro;
+                p += sizeof("Pro") - 1;
+            } else if (strncmp(p, "Air", sizeof("Air") - 1) == 0) {
+                model.family = ModelFamily::MacBookAir;
+                p += sizeof("Air") - 1;
+            } else {
+                model.family = ModelFamily::MacBook;
+            }
+        } else if (strncmp(p, "mini", sizeof("mini") - 1) == 0) {
+            model.family = ModelFamily::Macmini;
+            p += sizeof("mini") - 1;
+        } else if (strncmp(p, "Pro", sizeof("Pro") - 1) == 0) {
+            model.family = ModelFamily::MacPro;
+            p += sizeof("Pro") - 1;
+        }
+    }
+    if (model.family == ModelFamily::Unknown) {
+        return false;
+    }
+
+    // Major numbers are short and never start with a zero, cap them to avoid overflowing on garbage
+    const char *start = p;
+    while (*p >= '0' && *p <= '9' && p - start < 4 && !(p == start && *p == '0')) {
+        model.major = model.major * 10 + static_cast<uint32_t>(*p - '0');
+        p++;
+    }
+    if (p == start || *p++ != ',' || *p < '0' || *p > '9') {
+        model.family = ModelFamily::Unknown;
+        return false;
+    }
+    model.minor = static_cast<uint32_t>(*p - '0');
+    return true;
+}
+
+// Constant time lookup of the range holding the model, nullptr for models needing no patches
+static inline const ModelRange *lookupModelRange(const ModelIdentifier &model) {
+    if (model.family == ModelFamily::Unknown || model.major >= kModelMaxMajor) {
+        return nullptr;
+    }
+    for (auto index : kModelLookup.ranges[static_cast<size_t>(model.family)][model.major]) {
+        if (index == 0) {
+            break;
+        }
+        const ModelRange &range = kModelRanges[index - 1];
+        if (model.minor >= range.minorFirst && model.minor <= range.minorLast) {
+            return &range;
+        }
+    }
+    return nullptr;
+}
+
+#endif /* kern_model_info_hpp */
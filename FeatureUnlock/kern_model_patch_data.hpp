@@ -0,0 +1,531 @@
+//
+//  kern_model_patch_data.hpp
+//  FeatureUnlock
+//
+//  Generated by Tools/patch_gen from Tools/model_patches.spec, do not edit.
+//
+
+#ifndef kern_model_patch_data_hpp
+#define kern_model_patch_data_hpp
+
+#pragma mark - Sidecar (MacBookPro)
+
+// 148 bytes, anchored on ',' at 11 and ',' at 25, skip searched probing 0x00 at 147, writes bytes 0 - 133
+static const uint8_t kSideCarAirPlayMacBookProOriginal[] = {
+    // MacBookPro9,1 MacBookPro9,2 MacBookPro10,1 MacBookPro10,2
+    // MacBookPro11,1 MacBookPro11,2 MacBookPro11,3 MacBookPro11,4 MacBookPro11,5 MacBookPro12,1
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x39, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x39, 0x2C, 0x32, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x30, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x30, 0x2C, 0x32, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x32, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x33, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x34, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x35, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x32, 0x2C, 0x31, 0x00,
+};
+
+static const uint8_t kSideCarAirPlayMacBookProPatched[] = {
+    // NacBookPro9,1 NacBookPro9,2 NacBookPro10,1 NacBookPro10,2
+    // NacBookPro11,1 NacBookPro11,2 NacBookPro11,3 NacBookPro11,4 NacBookPro11,5 NacBookPro12,1
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x39, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x39, 0x2C, 0x32, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x30, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x30, 0x2C, 0x32, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x32, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x33, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x34, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x35, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x32, 0x2C, 0x31, 0x00,
+};
+
+static constexpr MatchAnchor kSideCarAirPlayMacBookProAnchor = selectAnchor(kSideCarAirPlayMacBookProOriginal);
+static constexpr SkipTable kSideCarAirPlayMacBookProSkip = buildSkipTable(kSideCarAirPlayMacBookProOriginal);
+static constexpr PatchDescriptor kSideCarAirPlayMacBookProDescriptor =
+    patchDescriptor("Sidecar (MacBookPro)", PatchTarget::SharedCache, FeatureSidecar, kModelsSidecarMacBookPro,
+                    osVersion(KernelVersion::Catalina), osVersion(KernelVersion::Catalina, 0xFF), false,
+                    kSideCarAirPlayMacBookProOriginal, kSideCarAirPlayMacBookProPatched, kSideCarAirPlayMacBookProAnchor, kSideCarAirPlayMacBookProSkip);
+
+#pragma mark - Sidecar (MacBook/MacBookAir)
+
+// 95 bytes, anchored on ',' at 8 and ',' at 22, skip searched probing 0x00 at 94, writes bytes 0 - 81
+static const uint8_t kSideCarAirPlayMacBookOriginal[] = {
+    // MacBook8,1
+    // MacBookAir5,1 MacBookAir5,2 MacBookAir6,1 MacBookAir6,2 MacBookAir7,1 MacBookAir7,2
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x38, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x35, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x35, 0x2C, 0x32, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x36, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x36, 0x2C, 0x32, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x32, 0x00,
+};
+
+static const uint8_t kSideCarAirPlayMacBookPatched[] = {
+    // NacBook8,1
+    // NacBookAir5,1 NacBookAir5,2 NacBookAir6,1 NacBookAir6,2 NacBookAir7,1 NacBookAir7,2
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x38, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x35, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x35, 0x2C, 0x32, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x36, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x36, 0x2C, 0x32, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x32, 0x00,
+};
+
+static constexpr MatchAnchor kSideCarAirPlayMacBookAnchor = selectAnchor(kSideCarAirPlayMacBookOriginal);
+static constexpr SkipTable kSideCarAirPlayMacBookSkip = buildSkipTable(kSideCarAirPlayMacBookOriginal);
+static constexpr PatchDescriptor kSideCarAirPlayMacBookDescriptor =
+    patchDescriptor("Sidecar (MacBook/MacBookAir)", PatchTarget::SharedCache, FeatureSidecar, kModelsSidecarMacBook,
+                    osVersion(KernelVersion::Catalina), osVersion(KernelVersion::Catalina, 0xFF), false,
+                    kSideCarAirPlayMacBookOriginal, kSideCarAirPlayMacBookPatched, kSideCarAirPlayMacBookAnchor, kSideCarAirPlayMacBookSkip);
+
+#pragma mark - Sidecar (iMac)
+
+// 90 bytes, anchored on ',' at 6 and ',' at 15, skip searched probing 0x00 at 89, writes bytes 1 - 82
+static const uint8_t kSideCarAirPlayiMacOriginal[] = {
+    // iMac13,1 iMac13,2 iMac13,3 iMac14,1 iMac14,2 iMac14,3 iMac14,4 iMac15,1 iMac16,1 iMac16,2
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x31, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x32, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x33, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x31, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x32, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x33, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x34, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x35, 0x2C, 0x31, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x31, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x32, 0x00,
+};
+
+static const uint8_t kSideCarAirPlayiMacPatched[] = {
+    // iNac13,1 iNac13,2 iNac13,3 iNac14,1 iNac14,2 iNac14,3 iNac14,4 iNac15,1 iNac16,1 iNac16,2
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x31, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x32, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x33, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x31, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x32, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x33, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x34, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x35, 0x2C, 0x31, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x31, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x32, 0x00,
+};
+
+static constexpr MatchAnchor kSideCarAirPlayiMacAnchor = selectAnchor(kSideCarAirPlayiMacOriginal);
+static constexpr SkipTable kSideCarAirPlayiMacSkip = buildSkipTable(kSideCarAirPlayiMacOriginal);
+static constexpr PatchDescriptor kSideCarAirPlayiMacDescriptor =
+    patchDescriptor("Sidecar (iMac)", PatchTarget::SharedCache, FeatureSidecar, kModelsSidecariMac,
+                    osVersion(KernelVersion::Catalina), osVersion(KernelVersion::Catalina, 0xFF), false,
+                    kSideCarAirPlayiMacOriginal, kSideCarAirPlayiMacPatched, kSideCarAirPlayiMacAnchor, kSideCarAirPlayiMacSkip);
+
+#pragma mark - Sidecar (Macmini/MacPro)
+
+// 52 bytes, anchored on ',' at 8 and ',' at 19, skip searched probing '1' at 51, writes bytes 0 - 43
+static const uint8_t kSideCarAirPlayStandaloneDesktopOriginal[] = {
+    // Macmini6,1 Macmini6,2 Macmini7,1
+    // MacPro5,1 MacPro6,1
+    0x4D, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x36, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x36, 0x2C, 0x32, 0x00,
+    0x4D, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x37, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x35, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x36, 0x2C, 0x31,
+};
+
+static const uint8_t kSideCarAirPlayStandaloneDesktopPatched[] = {
+    // Nacmini6,1 Nacmini6,2 Nacmini7,1
+    // NacPro5,1 NacPro6,1
+    0x4E, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x36, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x36, 0x2C, 0x32, 0x00,
+    0x4E, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x37, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x35, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x36, 0x2C, 0x31,
+};
+
+static constexpr MatchAnchor kSideCarAirPlayStandaloneDesktopAnchor = selectAnchor(kSideCarAirPlayStandaloneDesktopOriginal);
+static constexpr SkipTable kSideCarAirPlayStandaloneDesktopSkip = buildSkipTable(kSideCarAirPlayStandaloneDesktopOriginal);
+static constexpr PatchDescriptor kSideCarAirPlayStandaloneDesktopDescriptor =
+    patchDescriptor("Sidecar (Macmini/MacPro)", PatchTarget::SharedCache, FeatureSidecar, kModelsSidecarDesktop,
+                    osVersion(KernelVersion::Catalina), osVersion(KernelVersion::Catalina, 0xFF), false,
+                    kSideCarAirPlayStandaloneDesktopOriginal, kSideCarAirPlayStandaloneDesktopPatched, kSideCarAirPlayStandaloneDesktopAnchor, kSideCarAirPlayStandaloneDesktopSkip);
+
+#pragma mark - Sidecar/AirPlay (MacBook Pro 2012)
+
+// 58 bytes, anchored on ',' at 11 and ',' at 25, skip searched probing 0x00 at 57, writes bytes 0 - 43
+static const uint8_t kSideCarAirPlayMacBookPro2012Original[] = {
+    // MacBookPro9,1 MacBookPro9,2 MacBookPro10,1 MacBookPro10,2
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x39, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x39, 0x2C, 0x32, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x30, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x30, 0x2C, 0x32, 0x00,
+};
+
+static const uint8_t kSideCarAirPlayMacBookPro2012Patched[] = {
+    // NacBookPro9,1 NacBookPro9,2 NacBookPro10,1 NacBookPro10,2
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x39, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x39, 0x2C, 0x32, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x30, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x30, 0x2C, 0x32, 0x00,
+};
+
+static constexpr MatchAnchor kSideCarAirPlayMacBookPro2012Anchor = selectAnchor(kSideCarAirPlayMacBookPro2012Original);
+static constexpr SkipTable kSideCarAirPlayMacBookPro2012Skip = buildSkipTable(kSideCarAirPlayMacBookPro2012Original);
+static constexpr PatchDescriptor kSideCarAirPlayMacBookPro2012Descriptor =
+    patchDescriptor("Sidecar/AirPlay (MacBook Pro 2012)", PatchTarget::SharedCache, FeatureSidecar | FeatureAirPlay, ModelMacBookPro2012,
+                    osVersion(KernelVersion::BigSur), kOsVersionLatest, false,
+                    kSideCarAirPlayMacBookPro2012Original, kSideCarAirPlayMacBookPro2012Patched, kSideCarAirPlayMacBookPro2012Anchor, kSideCarAirPlayMacBookPro2012Skip);
+
+#pragma mark - Sidecar/AirPlay (MacBook Pro 2013 - 2015)
+
+// 90 bytes, anchored on ',' at 12 and ',' at 27, skip searched probing 0x00 at 89, writes bytes 0 - 75
+static const uint8_t kSideCarAirPlayMacBookPro2013_2015Original[] = {
+    // MacBookPro11,1 MacBookPro11,2 MacBookPro11,3 MacBookPro11,4 MacBookPro11,5 MacBookPro12,1
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x32, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x33, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x34, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x35, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x32, 0x2C, 0x31, 0x00,
+};
+
+static const uint8_t kSideCarAirPlayMacBookPro2013_2015Patched[] = {
+    // NacBookPro11,1 NacBookPro11,2 NacBookPro11,3 NacBookPro11,4 NacBookPro11,5 NacBookPro12,1
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x32, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x33, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x34, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x35, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x32, 0x2C, 0x31, 0x00,
+};
+
+static constexpr MatchAnchor kSideCarAirPlayMacBookPro2013_2015Anchor = selectAnchor(kSideCarAirPlayMacBookPro2013_2015Original);
+static constexpr SkipTable kSideCarAirPlayMacBookPro2013_2015Skip = buildSkipTable(kSideCarAirPlayMacBookPro2013_2015Original);
+static constexpr PatchDescriptor kSideCarAirPlayMacBookPro2013_2015Descriptor =
+    patchDescriptor("Sidecar/AirPlay (MacBook Pro 2013 - 2015)", PatchTarget::SharedCache, FeatureSidecar | FeatureAirPlay, ModelMacBookPro2013 | ModelMacBookPro2015,
+                    osVersion(KernelVersion::BigSur), kOsVersionLatest, false,
+                    kSideCarAirPlayMacBookPro2013_2015Original, kSideCarAirPlayMacBookPro2013_2015Patched, kSideCarAirPlayMacBookPro2013_2015Anchor, kSideCarAirPlayMacBookPro2013_2015Skip);
+
+#pragma mark - Sidecar/AirPlay (MacBook 2015/MacBook Air 2012)
+
+// 39 bytes, anchored on ',' at 8 and ',' at 22, skip searched probing 0x00 at 38, writes bytes 0 - 25
+static const uint8_t kSideCarAirPlayMacBookMacBookAir2012Original[] = {
+    // MacBook8,1
+    // MacBookAir5,1 MacBookAir5,2
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x38, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x35, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x35, 0x2C, 0x32, 0x00,
+};
+
+static const uint8_t kSideCarAirPlayMacBookMacBookAir2012Patched[] = {
+    // NacBook8,1
+    // NacBookAir5,1 NacBookAir5,2
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x38, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x35, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x35, 0x2C, 0x32, 0x00,
+};
+
+static constexpr MatchAnchor kSideCarAirPlayMacBookMacBookAir2012Anchor = selectAnchor(kSideCarAirPlayMacBookMacBookAir2012Original);
+static constexpr SkipTable kSideCarAirPlayMacBookMacBookAir2012Skip = buildSkipTable(kSideCarAirPlayMacBookMacBookAir2012Original);
+static constexpr PatchDescriptor kSideCarAirPlayMacBookMacBookAir2012Descriptor =
+    patchDescriptor("Sidecar/AirPlay (MacBook 2015/MacBook Air 2012)", PatchTarget::SharedCache, FeatureSidecar | FeatureAirPlay, ModelMacBook2015 | ModelMacBookAir2012,
+                    osVersion(KernelVersion::BigSur), kOsVersionLatest, false,
+                    kSideCarAirPlayMacBookMacBookAir2012Original, kSideCarAirPlayMacBookMacBookAir2012Patched, kSideCarAirPlayMacBookMacBookAir2012Anchor, kSideCarAirPlayMacBookMacBookAir2012Skip);
+
+#pragma mark - Sidecar/AirPlay (MacBook Air 2013 - 2015)
+
+// 56 bytes, anchored on ',' at 11 and ',' at 25, skip searched probing 0x00 at 55, writes bytes 0 - 42
+static const uint8_t kSideCarAirPlayMacBookAir2013_2015Original[] = {
+    // MacBookAir6,1 MacBookAir6,2 MacBookAir7,1 MacBookAir7,2
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x36, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x36, 0x2C, 0x32, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x32, 0x00,
+};
+
+static const uint8_t kSideCarAirPlayMacBookAir2013_2015Patched[] = {
+    // NacBookAir6,1 NacBookAir6,2 NacBookAir7,1 NacBookAir7,2
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x36, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x36, 0x2C, 0x32, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x32, 0x00,
+};
+
+static constexpr MatchAnchor kSideCarAirPlayMacBookAir2013_2015Anchor = selectAnchor(kSideCarAirPlayMacBookAir2013_2015Original);
+static constexpr SkipTable kSideCarAirPlayMacBookAir2013_2015Skip = buildSkipTable(kSideCarAirPlayMacBookAir2013_2015Original);
+static constexpr PatchDescriptor kSideCarAirPlayMacBookAir2013_2015Descriptor =
+    patchDescriptor("Sidecar/AirPlay (MacBook Air 2013 - 2015)", PatchTarget::SharedCache, FeatureSidecar | FeatureAirPlay, ModelMacBookAir2013 | ModelMacBookAir2015,
+                    osVersion(KernelVersion::BigSur), kOsVersionLatest, false,
+                    kSideCarAirPlayMacBookAir2013_2015Original, kSideCarAirPlayMacBookAir2013_2015Patched, kSideCarAirPlayMacBookAir2013_2015Anchor, kSideCarAirPlayMacBookAir2013_2015Skip);
+
+#pragma mark - Sidecar/AirPlay (iMac 2012)
+
+// 27 bytes, anchored on ',' at 6 and ',' at 15, skip searched probing 0x00 at 26, writes bytes 1 - 19
+static const uint8_t kSideCarAirPlayiMacAlternative2012Original[] = {
+    // iMac13,1 iMac13,2 iMac13,3
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x31, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x32, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x33, 0x00,
+};
+
+static const uint8_t kSideCarAirPlayiMacAlternative2012Patched[] = {
+    // iNac13,1 iNac13,2 iNac13,3
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x31, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x32, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x33, 0x2C, 0x33, 0x00,
+};
+
+static constexpr MatchAnchor kSideCarAirPlayiMacAlternative2012Anchor = selectAnchor(kSideCarAirPlayiMacAlternative2012Original);
+static constexpr SkipTable kSideCarAirPlayiMacAlternative2012Skip = buildSkipTable(kSideCarAirPlayiMacAlternative2012Original);
+static constexpr PatchDescriptor kSideCarAirPlayiMacAlternative2012Descriptor =
+    patchDescriptor("Sidecar/AirPlay (iMac 2012)", PatchTarget::SharedCache, FeatureSidecar | FeatureAirPlay, ModeliMac2012,
+                    osVersion(KernelVersion::BigSur), kOsVersionLatest, false,
+                    kSideCarAirPlayiMacAlternative2012Original, kSideCarAirPlayiMacAlternative2012Patched, kSideCarAirPlayiMacAlternative2012Anchor, kSideCarAirPlayiMacAlternative2012Skip);
+
+#pragma mark - Sidecar/AirPlay (iMac 2013)
+
+// 36 bytes, anchored on ',' at 6 and ',' at 15, skip searched probing 0x00 at 35, writes bytes 1 - 28
+static const uint8_t kSideCarAirPlayiMacAlternative2013Original[] = {
+    // iMac14,1 iMac14,2 iMac14,3 iMac14,4
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x31, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x32, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x33, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x34, 0x00,
+};
+
+static const uint8_t kSideCarAirPlayiMacAlternative2013Patched[] = {
+    // iNac14,1 iNac14,2 iNac14,3 iNac14,4
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x31, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x32, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x33, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x34, 0x2C, 0x34, 0x00,
+};
+
+static constexpr MatchAnchor kSideCarAirPlayiMacAlternative2013Anchor = selectAnchor(kSideCarAirPlayiMacAlternative2013Original);
+static constexpr SkipTable kSideCarAirPlayiMacAlternative2013Skip = buildSkipTable(kSideCarAirPlayiMacAlternative2013Original);
+static constexpr PatchDescriptor kSideCarAirPlayiMacAlternative2013Descriptor =
+    patchDescriptor("Sidecar/AirPlay (iMac 2013)", PatchTarget::SharedCache, FeatureSidecar | FeatureAirPlay, ModeliMac2013,
+                    osVersion(KernelVersion::BigSur), kOsVersionLatest, false,
+                    kSideCarAirPlayiMacAlternative2013Original, kSideCarAirPlayiMacAlternative2013Patched, kSideCarAirPlayiMacAlternative2013Anchor, kSideCarAirPlayiMacAlternative2013Skip);
+
+#pragma mark - Sidecar/AirPlay (iMac 2014)
+
+// 27 bytes, anchored on ',' at 6 and ',' at 15, skip searched probing 0x00 at 26, writes bytes 1 - 19
+static const uint8_t kSideCarAirPlayiMacAlternative2014Original[] = {
+    // iMac15,1 iMac16,1 iMac16,2
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x35, 0x2C, 0x31, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x31, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x32, 0x00,
+};
+
+static const uint8_t kSideCarAirPlayiMacAlternative2014Patched[] = {
+    // iNac15,1 iNac16,1 iNac16,2
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x35, 0x2C, 0x31, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x31, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x32, 0x00,
+};
+
+static constexpr MatchAnchor kSideCarAirPlayiMacAlternative2014Anchor = selectAnchor(kSideCarAirPlayiMacAlternative2014Original);
+static constexpr SkipTable kSideCarAirPlayiMacAlternative2014Skip = buildSkipTable(kSideCarAirPlayiMacAlternative2014Original);
+static constexpr PatchDescriptor kSideCarAirPlayiMacAlternative2014Descriptor =
+    patchDescriptor("Sidecar/AirPlay (iMac 2014)", PatchTarget::SharedCache, FeatureSidecar | FeatureAirPlay, ModeliMac2014 | ModeliMac2015Broadwell,
+                    osVersion(KernelVersion::BigSur), kOsVersionLatest, false,
+                    kSideCarAirPlayiMacAlternative2014Original, kSideCarAirPlayiMacAlternative2014Patched, kSideCarAirPlayiMacAlternative2014Anchor, kSideCarAirPlayiMacAlternative2014Skip);
+
+#pragma mark - Sidecar/AirPlay (Mac mini 2012 - 2014)
+
+// 33 bytes, anchored on ',' at 8 and ',' at 19, skip searched probing 0x00 at 32, writes bytes 0 - 22
+static const uint8_t kSideCarAirPlayMacminiOriginal[] = {
+    // Macmini6,1 Macmini6,2 Macmini7,1
+    0x4D, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x36, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x36, 0x2C, 0x32, 0x00,
+    0x4D, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x37, 0x2C, 0x31, 0x00,
+};
+
+static const uint8_t kSideCarAirPlayMacminiPatched[] = {
+    // Nacmini6,1 Nacmini6,2 Nacmini7,1
+    0x4E, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x36, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x36, 0x2C, 0x32, 0x00,
+    0x4E, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x37, 0x2C, 0x31, 0x00,
+};
+
+static constexpr MatchAnchor kSideCarAirPlayMacminiAnchor = selectAnchor(kSideCarAirPlayMacminiOriginal);
+static constexpr SkipTable kSideCarAirPlayMacminiSkip = buildSkipTable(kSideCarAirPlayMacminiOriginal);
+static constexpr PatchDescriptor kSideCarAirPlayMacminiDescriptor =
+    patchDescriptor("Sidecar/AirPlay (Mac mini 2012 - 2014)", PatchTarget::SharedCache, FeatureSidecar | FeatureAirPlay, ModelMacmini2012 | ModelMacmini2014,
+                    osVersion(KernelVersion::BigSur), kOsVersionLatest, false,
+                    kSideCarAirPlayMacminiOriginal, kSideCarAirPlayMacminiPatched, kSideCarAirPlayMacminiAnchor, kSideCarAirPlayMacminiSkip);
+
+#pragma mark - Sidecar/AirPlay (Mac Pro 2010 - 2013)
+
+// 19 bytes, anchored on ',' at 7 and ',' at 17, skip searched probing '1' at 18, writes bytes 0 - 10
+static const uint8_t kSideCarAirPlayMacProOriginal[] = {
+    // MacPro5,1 MacPro6,1
+    0x4D, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x35, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x36, 0x2C, 0x31,
+};
+
+static const uint8_t kSideCarAirPlayMacProPatched[] = {
+    // NacPro5,1 NacPro6,1
+    0x4E, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x35, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x36, 0x2C, 0x31,
+};
+
+static constexpr MatchAnchor kSideCarAirPlayMacProAnchor = selectAnchor(kSideCarAirPlayMacProOriginal);
+static constexpr SkipTable kSideCarAirPlayMacProSkip = buildSkipTable(kSideCarAirPlayMacProOriginal);
+static constexpr PatchDescriptor kSideCarAirPlayMacProDescriptor =
+    patchDescriptor("Sidecar/AirPlay (Mac Pro 2010 - 2013)", PatchTarget::SharedCache, FeatureSidecar | FeatureAirPlay, ModelMacPro2013 | ModelMacPro2010_2012,
+                    osVersion(KernelVersion::BigSur), kOsVersionLatest, false,
+                    kSideCarAirPlayMacProOriginal, kSideCarAirPlayMacProPatched, kSideCarAirPlayMacProAnchor, kSideCarAirPlayMacProSkip);
+
+#pragma mark - AirPlay to Mac (Extended)
+
+// 129 bytes, anchored on ',' at 6 and ',' at 15, skip searched probing 'c' at 128, writes bytes 1 - 126
+static const uint8_t kMacModelAirplayExtendedOriginal[] = {
+    // iMac17,1 iMac18,1 iMac18,2 iMac18,3
+    // MacBookPro13,1 MacBookPro13,2 MacBookPro13,3 MacBookPro14,1 MacBookPro14,2 MacBookPro14,3
+    // Mac*
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x37, 0x2C, 0x31, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x38, 0x2C, 0x31, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x38, 0x2C, 0x32, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x38, 0x2C, 0x33, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x33, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x33, 0x2C, 0x32, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x33, 0x2C, 0x33, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x34, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x34, 0x2C, 0x32, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x34, 0x2C, 0x33, 0x00,
+    0x4D, 0x61, 0x63,
+};
+
+static const uint8_t kMacModelAirplayExtendedPatched[] = {
+    // iNac17,1 iNac18,1 iNac18,2 iNac18,3
+    // NacBookPro13,1 NacBookPro13,2 NacBookPro13,3 NacBookPro14,1 NacBookPro14,2 NacBookPro14,3
+    // Nac*
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x37, 0x2C, 0x31, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x38, 0x2C, 0x31, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x38, 0x2C, 0x32, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x38, 0x2C, 0x33, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x33, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x33, 0x2C, 0x32, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x33, 0x2C, 0x33, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x34, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x34, 0x2C, 0x32, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x34, 0x2C, 0x33, 0x00,
+    0x4E, 0x61, 0x63,
+};
+
+static constexpr MatchAnchor kMacModelAirplayExtendedAnchor = selectAnchor(kMacModelAirplayExtendedOriginal);
+static constexpr SkipTable kMacModelAirplayExtendedSkip = buildSkipTable(kMacModelAirplayExtendedOriginal);
+static constexpr PatchDescriptor kMacModelAirplayExtendedDescriptor =
+    patchDescriptor("AirPlay to Mac (Extended)", PatchTarget::SharedCache, FeatureAirPlay, kModelsAirPlayExtended,
+                    osVersion(KernelVersion::Monterey), kOsVersionLatest, false,
+                    kMacModelAirplayExtendedOriginal, kMacModelAirplayExtendedPatched, kMacModelAirplayExtendedAnchor, kMacModelAirplayExtendedSkip);
+
+#pragma mark - Sidecar (iPad)
+
+// 121 bytes, anchored on ',' at 5 and ',' at 13, skip searched probing '2' at 120, writes bytes 0 - 113
+static const uint8_t kSidecariPadModelOriginal[] = {
+    // iPad4,1 iPad4,2 iPad4,3 iPad4,4 iPad4,5 iPad4,6 iPad4,7 iPad4,8 iPad4,9
+    // iPad5,1 iPad5,2 iPad5,3 iPad5,4 iPad6,11 iPad6,12
+    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x31, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x32, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x33, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x34, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x35, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x36, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x37, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x38, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x39, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x31, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x32, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x33, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x34, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x36, 0x2C, 0x31, 0x31, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x36, 0x2C, 0x31, 0x32,
+};
+
+static const uint8_t kSidecariPadModelPatched[] = {
+    // hPad4,1 hPad4,2 hPad4,3 hPad4,4 hPad4,5 hPad4,6 hPad4,7 hPad4,8 hPad4,9
+    // hPad5,1 hPad5,2 hPad5,3 hPad5,4 hPad6,11 hPad6,12
+    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x31, 0x00,
+    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x32, 0x00,
+    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x33, 0x00,
+    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x34, 0x00,
+    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x35, 0x00,
+    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x36, 0x00,
+    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x37, 0x00,
+    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x38, 0x00,
+    0x68, 0x50, 0x61, 0x64, 0x34, 0x2C, 0x39, 0x00,
+    0x68, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x31, 0x00,
+    0x68, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x32, 0x00,
+    0x68, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x33, 0x00,
+    0x68, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x34, 0x00,
+    0x68, 0x50, 0x61, 0x64, 0x36, 0x2C, 0x31, 0x31, 0x00,
+    0x68, 0x50, 0x61, 0x64, 0x36, 0x2C, 0x31, 0x32,
+};
+
+static constexpr MatchAnchor kSidecariPadModelAnchor = selectAnchor(kSidecariPadModelOriginal);
+static constexpr SkipTable kSidecariPadModelSkip = buildSkipTable(kSidecariPadModelOriginal);
+static constexpr PatchDescriptor kSidecariPadModelDescriptor =
+    patchDescriptor("Sidecar (iPad)", PatchTarget::SharedCache, FeatureSidecariPad, 0,
+                    osVersion(KernelVersion::Catalina), kOsVersionLatest, true,
+                    kSidecariPadModelOriginal, kSidecariPadModelPatched, kSidecariPadModelAnchor, kSidecariPadModelSkip);
+
+#pragma mark - Universal Control (app)
+
+// 161 bytes, anchored on ',' at 6 and ',' at 15, skip searched probing '1' at 160, writes bytes 1 - 152
+static const uint8_t kUniversalControlOriginal[] = {
+    // iMac16,1 iMac16,2
+    // iPad5,1 iPad5,2 iPad5,3 iPad5,4 iPad6,11 iPad6,12
+    // MacBookAir7,1 MacBookAir7,2
+    // MacBookPro11,4 MacBookPro11,5 MacBookPro12,1
+    // Macmini7,1 MacPro6,1
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x31, 0x00,
+    0x69, 0x4D, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x32, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x31, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x32, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x33, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x35, 0x2C, 0x34, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x36, 0x2C, 0x31, 0x31, 0x00,
+    0x69, 0x50, 0x61, 0x64, 0x36, 0x2C, 0x31, 0x32, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x32, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x34, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x35, 0x00,
+    0x4D, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x32, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x37, 0x2C, 0x31, 0x00,
+    0x4D, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x36, 0x2C, 0x31,
+};
+
+static const uint8_t kUniversalControlPatched[] = {
+    // iNac16,1 iNac16,2
+    // iQad5,1 iQad5,2 iQad5,3 iQad5,4 iQad6,11 iQad6,12
+    // NacBookAir7,1 NacBookAir7,2
+    // NacBookPro11,4 NacBookPro11,5 NacBookPro12,1
+    // Nacmini7,1 NacPro6,1
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x31, 0x00,
+    0x69, 0x4E, 0x61, 0x63, 0x31, 0x36, 0x2C, 0x32, 0x00,
+    0x69, 0x51, 0x61, 0x64, 0x35, 0x2C, 0x31, 0x00,
+    0x69, 0x51, 0x61, 0x64, 0x35, 0x2C, 0x32, 0x00,
+    0x69, 0x51, 0x61, 0x64, 0x35, 0x2C, 0x33, 0x00,
+    0x69, 0x51, 0x61, 0x64, 0x35, 0x2C, 0x34, 0x00,
+    0x69, 0x51, 0x61, 0x64, 0x36, 0x2C, 0x31, 0x31, 0x00,
+    0x69, 0x51, 0x61, 0x64, 0x36, 0x2C, 0x31, 0x32, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x41, 0x69, 0x72, 0x37, 0x2C, 0x32, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x34, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x31, 0x2C, 0x35, 0x00,
+    0x4E, 0x61, 0x63, 0x42, 0x6F, 0x6F, 0x6B, 0x50, 0x72, 0x6F, 0x31, 0x32, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x6D, 0x69, 0x6E, 0x69, 0x37, 0x2C, 0x31, 0x00,
+    0x4E, 0x61, 0x63, 0x50, 0x72, 0x6F, 0x36, 0x2C, 0x31,
+};
+
+static constexpr MatchAnchor kUniversalControlAnchor = selectAnchor(kUniversalControlOriginal);
+static constexpr SkipTable kUniversalControlSkip = buildSkipTable(kUniversalControlOriginal);
+static constexpr PatchDescriptor kUniversalControlDescriptor =
+    patchDescriptor("Universal Control (app)", PatchTarget::UniversalControl, FeatureUniversalControl, kModelsUniversalControl,
+                    osVersion(KernelVersion::Monterey, 4), kOsVersionLatest, false,
+                    kUniversalControlOriginal, kUniversalControlPatched, kUniversalControlAnchor, kUniversalControlSkip);
+
+#endif /* kern_model_patch_data_hpp */
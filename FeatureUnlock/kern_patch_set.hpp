@@ -0,0 +1,202 @@
+//
+//  kern_patch_set.hpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+// Registry of every patch set known to FeatureUnlock.
+// Each descriptor states where the patch applies, on which OS and models, and which
+// feature it unlocks. pluginStart resolves the registry once against the host, the
+// hooks then only walk the resulting active patches.
+
+#ifndef kern_patch_set_hpp
+#define kern_patch_set_hpp
+
+#include <Headers/kern_util.hpp>
+#include "kern_signature.hpp"
+#include "kern_dyld_patch.hpp"
+#include "kern_usr_patch.hpp"
+#include "kern_model_info.hpp"
+
+#pragma mark - Descriptor Types
+
+enum class PatchTarget : uint8_t {
+    SharedCache,
+    UniversalControl,
+    ControlCenter,
+    Count
+};
+
+// Features a patch set unlocks, gated by boot arguments and host capabilities
+enum PatchFeature : uint32_t {
+    FeatureNightShift       = 1U << 0,
+    FeatureSidecar          = 1U << 1,  // SidecarCore model check
+    FeatureAirPlay          = 1U << 2,  // AirPlaySupport model check
+    FeatureSidecariPad      = 1U << 3,
+    FeatureUniversalControl = 1U << 4,
+    FeatureAirPlayVmm       = 1U << 5,
+    FeatureContinuity       = 1U << 6,
+};
+
+// Kernel major and minor version packed for range checks
+static constexpr uint32_t osVersion(KernelVersion major, KernelMinorVersion minor = 0) {
+    return (static_cast<uint32_t>(major) << 8) | static_cast<uint32_t>(minor);
+}
+
+static constexpr uint32_t kOsVersionLatest = UINT32_MAX;
+
+struct PatchDescriptor {
+    const char *name;
+    PatchTarget target;
+    uint32_t features;  // PatchFeature mask, the shared cache is expected to match once per enabled feature
+    uint32_t models;    // ModelClass mask, 0 for every model
+    uint32_t minOs;
+    uint32_t maxOs;     // inclusive
+    bool oneShot;       // stop looking for the patch once applied
+    const uint8_t *find;
+    const uint8_t *findMask;
+    const uint8_t *replace;
+    const uint8_t *replaceMask;
+    size_t size;
+    MatchAnchor anchor;
+    MatchEngine engine; // search engine, see selectMatchEngine
+    const SkipTable *skip;  // set for MatchEngine::Horspool
+    MatchSpan diff;         // bytes changed by the replacement
+
+    constexpr MatchPattern pattern() const {
+        return {find, findMask, replace, replaceMask, size, anchor, diff};
+    }
+};
+
+// Patterns are skip searched when given a skip table, selectMatchEngine decides which ones are
+template <size_t N>
+static constexpr PatchDescriptor patchDescriptor(const char *name, PatchTarget target, uint32_t features, uint32_t models, uint32_t minOs, uint32_t maxOs, bool oneShot,
+                                                 const uint8_t (&find)[N], const uint8_t (&replace)[N], MatchAnchor anchor) {
+    return {name, target, features, models, minOs, maxOs, oneShot, find, nullptr, replace, nullptr, N, anchor, MatchEngine::Anchor, nullptr,
+            diffSpan(find, replace)};
+}
+
+template <size_t N>
+static constexpr PatchDescriptor patchDescriptor(const char *name, PatchTarget target, uint32_t features, uint32_t models, uint32_t minOs, uint32_t maxOs, bool oneShot,
+                                                 const uint8_t (&find)[N], const uint8_t (&replace)[N], MatchAnchor anchor, const SkipTable &skip) {
+    return {name, target, features, models, minOs, maxOs, oneShot, find, nullptr, replace, nullptr, N, anchor, MatchEngine::Horspool, &skip,
+            diffSpan(find, replace)};
+}
+
+template <size_t N>
+static constexpr PatchDescriptor patchDescriptor(const char *name, PatchTarget target, uint32_t features, uint32_t models, uint32_t minOs, uint32_t maxOs, bool oneShot,
+                                                 const SignaturePatch<N> &patch) {
+    return {name, target, features, models, minOs, maxOs, oneShot, patch.find.bytes, patch.find.masked ? patch.find.mask : nullptr,
+            patch.replace.bytes, patch.replace.masked ? patch.replace.mask : nullptr, N, patch.anchor, selectMatchEngine(patch.skip, N),
+            selectMatchEngine(patch.skip, N) == MatchEngine::Horspool ? &patch.skip : nullptr,
+            diffSpan(patch.find.bytes, patch.find.masked ? patch.find.mask : nullptr,
+                     patch.replace.bytes, patch.replace.masked ? patch.replace.mask : nullptr, N)};
+}
+
+#pragma mark - Model Groups
+
+// Pre-Ivy Bridge models lacking the NightShift capable display stack
+static constexpr uint32_t kModelsNightShift =
+    ModeliMacPre2012 | ModelMacProPre2010 | ModelMacPro2010_2012 | ModelMacminiPre2012 |
+    ModelMacBookPre2015 | ModelMacBookAirPre2012 | ModelMacBookProPre2012;
+
+// Ivy Bridge to Broadwell (including MacPro5,1) blocked from Sidecar and AirPlay to Mac
+static constexpr uint32_t kModelsSidecarMacBookPro = ModelMacBookPro2012 | ModelMacBookPro2013 | ModelMacBookPro2015;
+static constexpr uint32_t kModelsSidecarMacBook = ModelMacBookAir2012 | ModelMacBookAir2013 | ModelMacBookAir2015 | ModelMacBook2015;
+static constexpr uint32_t kModelsSidecariMac = ModeliMac2012 | ModeliMac2013 | ModeliMac2014 | ModeliMac2015Broadwell;
+static constexpr uint32_t kModelsSidecarDesktop = ModelMacmini2012 | ModelMacmini2014 | ModelMacPro2013 | ModelMacPro2010_2012;
+
+// Skylake and Kaby Lake models only blocked from AirPlay to Mac
+static constexpr uint32_t kModelsAirPlayExtended = ModelMacBookPro2016 | ModelMacBookPro2017 | ModeliMac2015_2017 | ModelMacmini2018;
+
+// Pre-Skylake models native to Monterey
+static constexpr uint32_t kModelsUniversalControl =
+    ModeliMac2015Broadwell | ModelMacPro2013 | ModelMacmini2014 | ModelMacBook2015 | ModelMacBookAir2015 | ModelMacBookPro2015;
+
+#pragma mark - Patch Descriptors
+
+// Model list patch sets, pre Big Sur patches are applied from _cs_validate_range, Big Sur and newer from _cs_validate_page
+#include "kern_model_patch_data.hpp"
+
+// Registration order is the order patches are applied to a page
+static constexpr PatchDescriptor kPatchDescriptors[] {
+    // Continuity Camera
+    patchDescriptor("Continuity Camera", PatchTarget::SharedCache, FeatureContinuity, 0,
+                    osVersion(KernelVersion::Ventura), kOsVersionLatest, true,
+                    kContinuityCameraPatch),
+
+    // NightShift
+    patchDescriptor("NightShift Legacy", PatchTarget::SharedCache, FeatureNightShift, kModelsNightShift,
+                    osVersion(KernelVersion::Sierra, 5), osVersion(KernelVersion::Sierra, 0xFF), true,
+                    kNightShiftLegacyOriginal, kNightShiftLegacyPatched, kNightShiftLegacyAnchor),
+    patchDescriptor("NightShift", PatchTarget::SharedCache, FeatureNightShift, kModelsNightShift,
+                    osVersion(KernelVersion::HighSierra, 2), kOsVersionLatest, true,
+                    kNightShiftOriginal, kNightShiftPatched, kNightShiftAnchor),
+
+    // Sidecar, Catalina
+    kSideCarAirPlayMacBookProDescriptor,
+    kSideCarAirPlayMacBookDescriptor,
+    kSideCarAirPlayiMacDescriptor,
+    kSideCarAirPlayStandaloneDesktopDescriptor,
+
+    // Sidecar and AirPlay to Mac, Big Sur and newer
+    kSideCarAirPlayMacBookPro2012Descriptor,
+    kSideCarAirPlayMacBookPro2013_2015Descriptor,
+    kSideCarAirPlayMacBookMacBookAir2012Descriptor,
+    kSideCarAirPlayMacBookAir2013_2015Descriptor,
+    kSideCarAirPlayiMacAlternative2012Descriptor,
+    kSideCarAirPlayiMacAlternative2013Descriptor,
+    kSideCarAirPlayiMacAlternative2014Descriptor,
+    kSideCarAirPlayMacminiDescriptor,
+    kSideCarAirPlayMacProDescriptor,
+    kMacModelAirplayExtendedDescriptor,
+
+    // Apple added kern.hv_vmm_present checks in Ventura, in addition to their normal model checks
+    patchDescriptor("AirPlay to Mac (VMM)", PatchTarget::SharedCache, FeatureAirPlayVmm, 0,
+                    osVersion(KernelVersion::Ventura), kOsVersionLatest, true,
+                    kAirPlayVmmOriginal, kAirPlayVmmPatched, kAirPlayVmmAnchor, kAirPlayVmmSkip),
+    patchDescriptor("Control Center (app)", PatchTarget::ControlCenter, FeatureAirPlayVmm, 0,
+                    osVersion(KernelVersion::Ventura), kOsVersionLatest, false,
+                    kGenericVmmOriginal, kGenericVmmPatched, kGenericVmmAnchor, kGenericVmmSkip),
+
+    // Sidecar iPad check
+    kSidecariPadModelDescriptor,
+
+    // Universal Control lives outside of the shared cache
+    kUniversalControlDescriptor,
+};
+
+static_assert(arrsize(kPatchDescriptors) <= kMaxMatchPatterns, "too many patch descriptors");
+
+static constexpr bool patchNameEquals(const char *a, const char *b) {
+    while (*a != '\0' && *a == *b) {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+// Registry position of the patch with the given name, arrsize(kPatchDescriptors) when unknown.
+// Names identify patches in the statistics, as positions change whenever the registry does.
+static constexpr size_t findPatchDescriptor(const char *name) {
+    for (size_t i = 0; i < arrsize(kPatchDescriptors); i++) {
+        if (patchNameEquals(kPatchDescriptors[i].name, name)) {
+            return i;
+        }
+    }
+    return arrsize(kPatchDescriptors);
+}
+
+static constexpr bool uniquePatchNames() {
+    for (size_t i = 0; i < arrsize(kPatchDescriptors); i++) {
+        if (findPatchDescriptor(kPatchDescriptors[i].name) != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(uniquePatchNames(), "patch descriptor names are not unique");
+
+#endif /* kern_patch_set_hpp */
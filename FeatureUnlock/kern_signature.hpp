@@ -0,0 +1,110 @@
+//
+//  kern_signature.hpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+// Byte signatures written as IDA-style strings, ie. "48 8B 05 ?? ?? ?? ??".
+// Strings are parsed at compile time into the needle, its mask and its anchor, nothing
+// is parsed at runtime. A malformed string fails the build instead of producing a wrong pattern.
+// Header is intentionally free of Lilu/XNU dependencies.
+
+#ifndef kern_signature_hpp
+#define kern_signature_hpp
+
+#include "kern_matcher.hpp"
+
+// Never defined, reaching it while evaluating a signature fails the build at the offending call
+void signatureError(const char *message);
+
+static constexpr int signatureNibble(char c) {
+    return c >= '0' && c <= '9' ? c - '0' :
+           c >= 'A' && c <= 'F' ? c - 'A' + 10 :
+           c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+}
+
+// Number of bytes of a signature, tokens are two hex digits or ?? separated by spaces
+static constexpr size_t signatureSize(const char *text) {
+    size_t size = 0;
+    for (size_t i = 0; text[i] != '\0';) {
+        if (text[i] == ' ') {
+            i++;
+            continue;
+        }
+        if (text[i + 1] == '\0' || (text[i + 2] != ' ' && text[i + 2] != '\0')) {
+            signatureError("signature tokens must be two characters long");
+        }
+        size++;
+        i += 2;
+    }
+    if (size == 0) {
+        signatureError("signature is empty");
+    }
+    return size;
+}
+
+template <size_t N>
+struct Signature {
+    uint8_t bytes[N];  // 0 for wildcards
+    uint8_t mask[N];   // 0xFF for fixed bytes, 0 for wildcards
+    bool masked;       // holds any wildcard
+};
+
+template <size_t N>
+static constexpr Signature<N> parseSignature(const char *text) {
+    Signature<N> signature {};
+    size_t size = 0;
+    for (size_t i = 0; text[i] != '\0';) {
+        if (text[i] == ' ') {
+            i++;
+            continue;
+        }
+        if (text[i] == '?' && text[i + 1] == '?') {
+            signature.masked = true;
+        } else {
+            int high = signatureNibble(text[i]);
+            int low = signatureNibble(text[i + 1]);
+            if (high < 0 || low < 0) {
+                signatureError("signature bytes must be hex digits or ??");
+            }
+            signature.bytes[size] = static_cast<uint8_t>((high << 4) | low);
+            signature.mask[size] = 0xFF;
+        }
+        size++;
+        i += 2;
+    }
+    return signature;
+}
+
+// Find and replace signatures of a patch, wildcards of the replacement keep the original byte
+template <size_t N>
+struct SignaturePatch {
+    Signature<N> find;
+    Signature<N> replace;
+    MatchAnchor anchor;
+    SkipTable skip;  // decides the search engine, only used when skip searched
+};
+
+template <size_t N>
+static constexpr SignaturePatch<N> signaturePatch(const char *find, const char *replace) {
+    if (signatureSize(replace) != N) {
+        signatureError("find and replace signatures differ in size");
+    }
+    SignaturePatch<N> patch {parseSignature<N>(find), parseSignature<N>(replace), {}, {}};
+    size_t fixed = 0;
+    for (size_t i = 0; i < N; i++) {
+        fixed += patch.find.mask[i] == 0xFF;
+    }
+    if (fixed < 2) {
+        signatureError("find signature needs two fixed bytes to anchor on");
+    }
+    patch.anchor = selectAnchor(patch.find.bytes, patch.find.masked ? patch.find.mask : nullptr, N);
+    patch.skip = buildSkipTable(patch.find.bytes, patch.find.masked ? patch.find.mask : nullptr, N);
+    return patch;
+}
+
+// Size is taken from the find signature, ie. SIGNATURE_PATCH("48 8B 05 ?? ??", "90 90 90 ?? ??")
+#define SIGNATURE_PATCH(find, replace) signaturePatch<signatureSize(find)>(find, replace)
+
+#endif /* kern_signature_hpp */
@@ -9,10 +9,18 @@
 #include <Headers/kern_api.hpp>
 #include <Headers/kern_user.hpp>
 #include <Headers/kern_devinfo.hpp>
+#include <Headers/kern_file.hpp>
+#include <IOKit/IOLocks.h>
+#include <kern/thread_call.h>
+#include <mach/machine.h>
 #include <sys/sysctl.h>
 #include "kern_dyld_patch.hpp"
 #include "kern_usr_patch.hpp"
 #include "kern_model_info.hpp"
+#include "kern_matcher.hpp"
+#include "kern_patch_set.hpp"
+#include "kern_stats.hpp"
+#include "kern_cache_map.hpp"
 
 #define MODULE_SHORT "fu_fix"
 
@@ -25,685 +33,1417 @@ bool disable_sidecar_mac;
 bool disable_nightshift;
 bool force_universal_control;
 
-// OS Feature Set
-bool os_supports_nightshift_old;
-bool os_supports_nightshift_new;
-bool os_supports_sidecar;
-bool os_supports_airplay_to_mac;
-bool os_supports_airplay_to_mac_vmm_checks;
-bool os_supports_universal_control;
-
-// Host needs patches
-bool host_needs_nightshift_patch;
-bool host_needs_sidecar_patch;
-bool host_needs_airplay_to_mac_patch;
-bool host_needs_airplay_to_mac_vmm_patch;
-bool host_needs_universal_control_patch;
-bool host_needs_continuity_patch;
-int  host_needs_vmm_patch;
-
-// Model family detected
-bool model_is_iMac_pre_2012;        // iMac7,1 - iMac12,x
-bool model_is_iMac_2012;            // iMac13,x
-bool model_is_iMac_2013;            // iMac14,x
-bool model_is_iMac_2014;            // iMac15,1
-bool model_is_iMac_2015_broadwell;  // iMac16,x
-bool model_is_iMac_2015_2017;       // iMac17,x - iMac18,x
-
-bool model_is_MacBook_pre_2015;     // MacBook4,1 - MacBook7,1
-bool model_is_MacBook_2015;         // MacBook8,1
-
-bool model_is_MacBookAir_pre_2012;  // MacBookAir2,1 - MacBookAir4,x
-bool model_is_MacBookAir_2012;      // MacBookAir5,x
-bool model_is_MacBookAir_2013;      // MacBookAir6,x
-bool model_is_MacBookAir_2015;      // MacBookAir7,x
-
-bool model_is_MacBookPro_pre_2012;  // MacBookPro4,1 - MacBookPro8,x
-bool model_is_MacBookPro_2012;      // MacBookPro9,x - MacBookPro10,x
-bool model_is_MacBookPro_2013;      // MacBookPro11,1 - 3
-bool model_is_MacBookPro_2015;      // MacBookPro11,4 - 5 - MacBookPro12,1
-bool model_is_MacBookPro_2016;      // MacBookPro13,x
-bool model_is_MacBookPro_2017;      // MacBookPro14,x
-
-bool model_is_Macmini_pre_2012;     // Macmini3,1 - Macmini5,x
-bool model_is_Macmini_2012;         // Macmini6,x
-bool model_is_Macmini_2014;         // Macmini7,x
-bool model_is_Macmini_2018;         // Macmini8,x
-
-bool model_is_MacPro_pre_2013;      // MacPro3,1 - MacPro5,x
-bool model_is_MacPro_2010_2012;     // MacPro5,x
-bool model_is_MacPro_2013;          // MacPro6,x
-
-bool has_applied_nightshift_patch;
-bool has_applied_airplay_to_mac_vmm_patch;
-bool has_applied_iPad_sidecar_patch;
-bool has_applied_continuity_patch;
-
-
-// Misc variables
-int number_of_loops = 0;
-int total_allowed_loops = 0;
-
-uint64_t start_time;
-uint64_t current_time;
-
-bool time_to_exit = false;
+// Host properties
+ModelClass host_model;
+int host_vmm_present;
+int host_cpu_subtype;  // CPU_SUBTYPE_X86_64_H selects the x86_64h shared cache, 0 when unknown
+uint32_t host_features;  // PatchFeature mask supported by the OS and not disabled by boot-args
 
-#pragma mark - Kernel patching code
+// Dyld patching safety net, see patched_cs_validate_page
+static constexpr uint64_t kDyldPatchingTimeoutNs = 300ULL * 1000000000ULL;
 
-template <size_t findSize, size_t findMaskSize, size_t replaceSize, size_t replaceMaskSize>
-static inline bool searchAndPatchWithMask(const void *haystack, size_t haystackSize, const char *path, const uint8_t (&needle)[findSize], const uint8_t (&findMask)[findMaskSize], const uint8_t (&patch)[replaceSize], const uint8_t (&patchMask)[replaceMaskSize], const char *name, bool is_dyld) {
-    if (KernelPatcher::findAndReplaceWithMask(const_cast<void *>(haystack), haystackSize, needle, findSize, findMask, findMaskSize, patch, replaceSize, patchMask, replaceMaskSize, 0, 0)) {
-        DBGLOG(MODULE_SHORT, "found function %s to patch at %s!", name, path);
-        if (is_dyld) {
-            number_of_loops++;
-            DBGLOG(MODULE_SHORT, "number of loops: %d", number_of_loops);
-            if (number_of_loops == total_allowed_loops) {
-                DBGLOG(MODULE_SHORT, "Reached maximum loops (%d), no more dyld patching", total_allowed_loops);
-            }
-        }
-        return true;
+/*
+Every CPU validating pages runs the hook concurrently. Whatever the hook only reads is
+resolved into patch_config by pluginStart before the hook is routed and never written
+afterwards. The little the hook writes changes only when a patch applies, it lives in
+patch_progress on cache lines of its own.
+*/
+
+// Active dyld patch
+struct DyldPatch {
+    const PatchDescriptor *desc;
+    uint32_t quota;  // matches expected in the shared cache, one per enabled feature
+};
+
+struct PatchConfig {
+    uint64_t deadline;       // mach_absolute_time past which dyld patching gives up
+    uint32_t dyldPatchMask;  // patches registered with dyldMatcher
+    uint32_t dyldSkipMask;   // long patches skip searched one at a time rather than in the shared walk
+    uint32_t allowedLoops;   // sum of the quotas of active dyld patches
+    MultiPatternMatcher dyldMatcher;
+    DyldPatch dyldPatches[kMaxMatchPatterns];
+    const PatchDescriptor *binaryPatches[static_cast<size_t>(PatchTarget::Count)];
+    uint32_t targetClasses;  // VnodeClass bits of the files patched, other mounts are rejected once all were found
+    const char *sharedCacheName;  // shared cache variant mapped by userspace, nullptr to accept every variant
+};
+
+/*
+Work left for the validation hook, the hook is bypassed once none is left.
+Only HookWorkDyld is ever cleared. Evicted pages are read again from disk unpatched, so
+binary patches and re-page sites are needed for as long as their pages may be validated,
+which is until shutdown. Any dyld patch applied records sites, thus the hook is fully
+bypassed only on hosts that applied no patch at all. Once only sites are left, pages of
+files other than the shared cache files holding them are bypassed after comparing their
+vnode, see isPatchSiteFile. Hosts patching UniversalControl or ControlCenter keep
+classifying every page, their steady state is the mount rejection in classifyVnode, which
+turns away files outside of the target volumes.
+*/
+enum HookWork : uint32_t {
+    HookWorkDyld   = 1U << 0,  // dyld patches expected and the deadline not passed yet
+    HookWorkBinary = 1U << 1,  // binary patches, applied again whenever their pages are validated again, never cleared
+    HookWorkSites  = 1U << 2,  // re-page sites recorded, applied again whenever their pages are validated again, never cleared
+};
+
+struct alignas(64) PatchProgress {
+    uint32_t work;     // HookWork mask, the hook returns right after the original once empty
+    uint32_t pending;  // patches still looked for, the CPU clearing a one-shot bit owns its accounting
+    uint32_t loops;    // matches counted against allowedLoops
+    bool expired;      // deadline passed, set once
+    alignas(64) uint32_t hits[kMaxMatchPatterns];
+};
+
+static PatchConfig patch_config;
+static PatchProgress patch_progress;
+
+// Page boundary carry-over
+static constexpr size_t kBoundarySlots = 16;
+static_assert(kBoundaryWindow <= UINT8_MAX, "boundary window does not fit edge size");
+
+struct BoundaryEdge {
+    vnode_t vp;
+    uint32_t vid;
+    memory_object_offset_t offset;  // page start for head edges, page end for tail edges
+    bool head;
+    uint8_t size;
+    uint8_t bytes[kBoundaryWindow];
+};
+
+// Re-page sites, see recordPatchSite
+static constexpr size_t kPatchSiteSlots = 128;
+static constexpr size_t kPatchSiteFileSlots = 8;  // shared cache files holding sites, main and sub caches
+static_assert((kPatchSiteSlots & (kPatchSiteSlots - 1)) == 0, "patch site table size must be a power of two");
+
+struct PatchSite {
+    uintptr_t file;  // vnode for shared caches, VnodeClass for binaries, 0 while free and written last
+    uint32_t vid;
+    uint16_t patch;  // position in kPatchDescriptors
+    uint8_t account; // dyld patch index + 1 of a split match counted once this site is applied, 0 otherwise
+    memory_object_offset_t page;
+    memory_object_offset_t offset;  // file offset of the match start
+};
+
+// Clean page cache, see markCleanPages
+static constexpr size_t kCleanRegionPages = 4096;  // 16 MB of a shared cache per region
+static constexpr size_t kCleanRegionSlots = 512;
+static constexpr size_t kCleanRegionProbes = 8;
+static_assert((kCleanRegionSlots & (kCleanRegionSlots - 1)) == 0, "clean region table size must be a power of two");
+
+struct CleanRegion {
+    uintptr_t file;  // shared cache vnode, 0 while free and written last
+    uint32_t vid;
+    uint32_t region;  // page number / kCleanRegionPages
+    uint64_t pages[kCleanRegionPages / 64];  // bit set once the page was searched without any match
+};
+
+// Shared cache and binary target ranges, see isCacheTargetRange
+static constexpr size_t kCacheMapSlots = 16;  // main and sub cache files of both x86_64 caches, and the binaries
+static constexpr size_t kMaxCacheMapRanges = 32;
+static constexpr size_t kCacheLayoutSlots = 4;
+static constexpr size_t kCacheSearchBlock = 64 * 1024;
+
+enum class CacheMapState : uint8_t {
+    Pending,     // waiting for mapSharedCaches, or for the layout of its main cache
+    Mapping,     // being read by mapSharedCaches
+    Filtered,    // only pages within the ranges are scanned, none without ranges
+    Unfiltered   // every page is scanned
+};
+
+struct CacheMap {
+    uintptr_t file;  // shared cache vnode or binary, keyed as patch sites, 0 while free and written last
+    uint32_t vid;
+    vnode_t vp;      // read by mapSharedCaches
+    uint32_t vpVid;
+    PatchTarget target;
+    CacheMapState state;  // ranges are written before the state is
+    uint8_t count;
+    CacheRange ranges[kMaxCacheMapRanges];
+    uint8_t uuid[16];  // of shared cache files, to find the sub caches of a layout
+    uint32_t found;    // patches found within the ranges, see searchCacheRanges
+    uint8_t matches[kMaxMatchPatterns];  // dyld patch matches within the ranges, compared with their quotas
+};
+
+// Vnode classification cache, see lookupVnodeClass
+enum class VnodeClass : uint8_t {
+    Unknown,
+    Irrelevant,
+    SharedCache,
+    UniversalControl,
+    ControlCenter
+};
+
+static constexpr size_t kVnodeCacheSlots = 512;
+static constexpr size_t kVnodeCacheProbes = 4;
+static_assert((kVnodeCacheSlots & (kVnodeCacheSlots - 1)) == 0, "vnode cache size must be a power of two");
+
+struct VnodeCacheEntry {
+    uint32_t seq;  // odd while the entry is being written
+    uint32_t vid;
+    vnode_t vp;
+    VnodeClass cls;
+};
+
+static VnodeCacheEntry vnode_cache[kVnodeCacheSlots];
+
+static constexpr uint32_t vnodeClassBit(VnodeClass cls) {
+    return 1U << static_cast<uint32_t>(cls);
+}
+
+// Mounts holding the patch targets, see rejectVnodeMount
+static constexpr size_t kTargetMountSlots = 4;
+static constexpr uint32_t kTargetMountsOverflow = 1U << 31;  // a target was found on a mount that could not be recorded
+
+static mount_t target_mounts[kTargetMountSlots];
+static uint32_t target_mount_classes;  // VnodeClass bits of the targets found so far
+
+static IOSimpleLock *boundary_lock;
+static BoundaryEdge boundary_edges[kBoundarySlots];
+static size_t boundary_edge_next;
+
+static IOSimpleLock *site_lock;
+static PatchSite patch_sites[kPatchSiteSlots];
+static uint32_t patch_site_count;  // read without the lock to skip the lookup
+static vnode_t patch_site_files[kPatchSiteFileSlots];
+static uint32_t patch_site_file_count;  // files are written before the count is
+static bool patch_site_files_full;      // a shared cache file could not be recorded, files cannot be told apart by vnode
+
+static IOSimpleLock *clean_lock;
+static CleanRegion *clean_regions;  // kCleanRegionSlots, allocated on start while dyld patches are active
+
+static IOSimpleLock *cache_map_lock;
+static thread_call_t cache_map_call;
+static CacheMap cache_maps[kCacheMapSlots];
+static CacheLayout cache_layouts[kCacheLayoutSlots];
+static size_t cache_layout_count;  // layouts are written before the count is
+static bool cache_map_fallback;    // the target images missed a pending patch, shared caches are scanned in full
+
+#pragma mark - Re-page sites
+
+/*
+Patched pages are dropped under memory pressure and validated again from the original
+file contents once touched. Every applied match is recorded per page it covers, so that
+a page validated again is patched at the known offsets without searching it.
+Shared caches are told apart by vnode, binaries by class so that their sites outlive
+vnode recycling; the original bytes are verified before every write either way.
+A page only gets sites once it was searched in full, hence a page holding any is not
+searched again. Sites are never removed, once the table is full new ones are dropped
+and their pages are searched as before.
+Shared cache vnodes holding sites are listed as well. Once dyld patching is over and no
+binary patch is active, sites are the only work left, and pages of every other file are
+turned away by comparing their vnode against the list, without classifying them.
+*/
+
+static void recordDyldPatch(size_t index, vnode_t vp);
+
+static inline uintptr_t patchSiteFile(vnode_t vp, VnodeClass cls, uint32_t &vid) {
+    if (cls == VnodeClass::SharedCache) {
+        vid = vnode_vid(vp);
+        return reinterpret_cast<uintptr_t>(vp);
     }
-    return false;
+    vid = 0;
+    return static_cast<uintptr_t>(cls);
 }
 
-template <size_t findSize, size_t replaceSize>
-static inline bool searchAndPatch(const void *haystack, size_t haystackSize, const char *path, const uint8_t (&needle)[findSize], const uint8_t (&patch)[replaceSize], const char *name, bool is_dyld) {
-    if (UNLIKELY(KernelPatcher::findAndReplace(const_cast<void *>(haystack), haystackSize, needle, findSize, patch, replaceSize))) {
-        DBGLOG(MODULE_SHORT, "found function %s to patch at %s!", name, path);
-        if (is_dyld) {
-            number_of_loops++;
-            DBGLOG(MODULE_SHORT, "number of loops: %d", number_of_loops);
-            if (number_of_loops == total_allowed_loops) {
-                DBGLOG(MODULE_SHORT, "Reached maximum loops (%d), no more dyld patching", total_allowed_loops);
-            }
-        }
-        return true;
+static inline memory_object_offset_t patchSitePage(memory_object_offset_t offset) {
+    return offset & ~static_cast<memory_object_offset_t>(PAGE_SIZE - 1);
+}
+
+static inline size_t patchSiteHash(uintptr_t file, memory_object_offset_t page) {
+    return static_cast<size_t>(((file ^ page) * 0x9E3779B97F4A7C15ULL) >> 32) & (kPatchSiteSlots - 1);
+}
+
+// Lists a shared cache vnode about to get sites, see isPatchSiteFile
+static void recordPatchSiteFile(vnode_t vp) {
+    if (!site_lock) {
+        return;
     }
-    return false;
+    IOSimpleLockLock(site_lock);
+    uint32_t count = patch_site_file_count;
+    bool listed = false;
+    for (uint32_t i = 0; i < count && !listed; i++) {
+        listed = patch_site_files[i] == vp;
+    }
+    if (!listed && count < kPatchSiteFileSlots) {
+        patch_site_files[count] = vp;
+        __atomic_store_n(&patch_site_file_count, count + 1, __ATOMIC_RELEASE);
+    } else if (!listed) {
+        __atomic_store_n(&patch_site_files_full, true, __ATOMIC_RELAXED);
+    }
+    IOSimpleLockUnlock(site_lock);
 }
 
-static inline bool check_time_elapsed() {
-    current_time = mach_absolute_time();
-    uint64_t elapsed_time = current_time - start_time;
-    uint64_t elapsed_time_ms = elapsed_time / 1000000;
-    // Check if 5 minutes have elapsed
-    if (elapsed_time_ms > 300000) {
-        DBGLOG(MODULE_SHORT, "Time elapsed since start: %llu ms, exiting", elapsed_time_ms);
-        time_to_exit = true;
+// Whether pages of the vnode may hold sites, when only shared cache sites are left
+static inline bool isPatchSiteFile(vnode_t vp) {
+    if (__atomic_load_n(&patch_site_files_full, __ATOMIC_RELAXED)) {
         return true;
     }
+    uint32_t count = __atomic_load_n(&patch_site_file_count, __ATOMIC_ACQUIRE);
+    for (uint32_t i = 0; i < count; i++) {
+        if (patch_site_files[i] == vp) {
+            return true;
+        }
+    }
     return false;
 }
 
-#pragma mark - Patched functions
-
-// pre Big Sur
-static boolean_t patched_cs_validate_range(vnode_t vp, memory_object_t pager, memory_object_offset_t offset, const void *data, vm_size_t size, unsigned *result) {
-    char path[PATH_MAX];
-    int pathlen = PATH_MAX;
-    boolean_t res = FunctionCast(patched_cs_validate_range, orig_cs_validate)(vp, pager, offset, data, size, result);
-    // If patch was successful, exit early
-    bool patch_result = false;
-
-    if (res && vn_getpath(vp, path, &pathlen) == 0 && UserPatcher::matchSharedCachePath(path)) {
-        if (number_of_loops >= total_allowed_loops) {
-            return res;
-        }
-        if (!disable_nightshift && host_needs_nightshift_patch && !has_applied_nightshift_patch) {
-            if (os_supports_nightshift_new) {
-                patch_result = searchAndPatch(data, size, path, kNightShiftOriginal, kNightShiftPatched, "NightShift", true);
-                if (patch_result) {
-                    has_applied_nightshift_patch = true;
-                    return res;
-                }
-            } else if (os_supports_nightshift_old) {
-                patch_result = searchAndPatch(data, size, path, kNightShiftLegacyOriginal, kNightShiftLegacyPatched, "NightShift Legacy", true);
-                if (patch_result) {
-                    has_applied_nightshift_patch = true;
-                    return res;
+// Records the match at offset for every page it covers within [from, to), the pages searched in full.
+// The site of accountPage gets account, the dyld patch index + 1 counted once that page is patched.
+static void recordPatchSite(uintptr_t file, uint32_t vid, memory_object_offset_t offset, const PatchDescriptor &patch,
+                            memory_object_offset_t from = 0, memory_object_offset_t to = UINT64_MAX,
+                            uint8_t account = 0, memory_object_offset_t accountPage = 0) {
+    if (!site_lock) {
+        return;
+    }
+    memory_object_offset_t start = patchSitePage(max(offset, from));
+    memory_object_offset_t end = min(offset + patch.size, to);
+    uint16_t index = static_cast<uint16_t>(&patch - kPatchDescriptors);
+    IOSimpleLockLock(site_lock);
+    for (memory_object_offset_t page = start; page < end; page += PAGE_SIZE) {
+        size_t slot = patchSiteHash(file, page);
+        for (size_t probe = 0; probe < kPatchSiteSlots; probe++) {
+            PatchSite &site = patch_sites[(slot + probe) & (kPatchSiteSlots - 1)];
+            if (site.file == file && site.vid == vid && site.page == page && site.offset == offset && site.patch == index) {
+                break;
+            }
+            if (site.file == 0) {
+                site.vid = vid;
+                site.patch = index;
+                site.account = page == accountPage ? account : 0;
+                site.page = page;
+                site.offset = offset;
+                // Lookups run without the lock, publish the entry once complete
+                __atomic_store_n(&site.file, file, __ATOMIC_RELEASE);
+                if (__atomic_add_fetch(&patch_site_count, 1, __ATOMIC_RELAXED) == 1) {
+                    __atomic_fetch_or(&patch_progress.work, HookWorkSites, __ATOMIC_RELAXED);
                 }
+                break;
             }
         }
+    }
+    IOSimpleLockUnlock(site_lock);
+}
 
-        if (!disable_sidecar_mac && os_supports_sidecar) {
-            if (host_needs_sidecar_patch) {
-                if (model_is_MacBookPro_2012 || model_is_MacBookPro_2013 || model_is_MacBookPro_2015) {
-                    patch_result = searchAndPatch(data, size, path, kSideCarAirPlayMacBookProOriginal, kSideCarAirPlayMacBookProPatched, "Sidecar (MacBookPro)", true);
-                    if (patch_result) {
-                        return res;
-                    }
-                } else if (model_is_MacBookAir_2012 || model_is_MacBookAir_2013 || model_is_MacBookAir_2015 || model_is_MacBook_2015) {
-                    patch_result = searchAndPatch(data, size, path, kSideCarAirPlayMacBookOriginal, kSideCarAirPlayMacBookPatched, "Sidecar (MacBook/MacBookAir)", true);
-                    if (patch_result) {
-                        return res;
-                    }
-                } else if (model_is_iMac_2012 || model_is_iMac_2013 || model_is_iMac_2014 || model_is_iMac_2015_broadwell) {
-                    patch_result = searchAndPatch(data, size, path, kSideCarAirPlayiMacOriginal, kSideCarAirPlayiMacPatched, "Sidecar (iMac)", true);
-                    if (patch_result) {
-                        return res;
-                    }
-                } else if (model_is_Macmini_2012 || model_is_Macmini_2014 || model_is_MacPro_2013 || model_is_MacPro_2010_2012) {
-                    patch_result = searchAndPatch(data, size, path, kSideCarAirPlayStandaloneDesktopOriginal, kSideCarAirPlayStandaloneDesktopPatched, "Sidecar (Macmini/MacPro)", true);
-                    if (patch_result) {
-                        return res;
-                    }
+// Applies the sites of the validated range, returns whether every page of it holds any
+static bool applyPatchSites(uintptr_t file, uint32_t vid, memory_object_offset_t offset, const void *data, size_t size, HookTimer &timer) {
+    if (LIKELY(__atomic_load_n(&patch_site_count, __ATOMIC_RELAXED) == 0)) {
+        return false;
+    }
+    uint8_t *bytes = static_cast<uint8_t *>(const_cast<void *>(data));
+    bool covered = true;
+    for (memory_object_offset_t page = patchSitePage(offset); page < offset + size; page += PAGE_SIZE) {
+        bool found = false;
+        size_t slot = patchSiteHash(file, page);
+        for (size_t probe = 0; probe < kPatchSiteSlots; probe++) {
+            PatchSite &site = patch_sites[(slot + probe) & (kPatchSiteSlots - 1)];
+            uintptr_t siteFile = __atomic_load_n(&site.file, __ATOMIC_ACQUIRE);
+            if (siteFile == 0) {
+                break;
+            }
+            if (siteFile != file || site.vid != vid || site.page != page) {
+                continue;
+            }
+            found = true;
+            // Matches straddling the range are patched a slice at a time
+            const PatchDescriptor &patch = kPatchDescriptors[site.patch];
+            uint64_t from = max(site.offset, offset);
+            uint64_t to = min(site.offset + patch.size, offset + size);
+            if (from >= to) {
+                continue;
+            }
+            size_t slice = static_cast<size_t>(from - site.offset);
+            size_t length = static_cast<size_t>(to - from);
+            uint8_t *at = bytes + (from - offset);
+            MatchPattern pattern = patch.pattern();
+            if (matchPattern(at, pattern, slice, length)) {
+                applyPattern(at, pattern, slice, length);
+                statsCountPatch(patch, length, 1, true, timer.lap(LatencyPhase::Patch));
+                // Split match complete, the first CPU to apply it accounts it
+                uint8_t account = __atomic_load_n(&site.account, __ATOMIC_RELAXED);
+                if (UNLIKELY(account != 0) && __atomic_exchange_n(&site.account, 0, __ATOMIC_RELAXED) == account) {
+                    recordDyldPatch(account - 1, reinterpret_cast<vnode_t>(file));
                 }
             }
         }
-        if (allow_sidecar_ipad && os_supports_sidecar && !has_applied_iPad_sidecar_patch) {
-            patch_result = searchAndPatch(data, size, path, kSidecariPadModelOriginal, kSidecariPadModelPatched, "Sidecar (iPad)", true);
-            if (patch_result) {
-                has_applied_iPad_sidecar_patch = true;
-                return res;
-            }
+        covered &= found;
+    }
+    return covered;
+}
+
+#pragma mark - Clean page cache
+
+/*
+Under memory pressure the same shared cache pages are evicted and validated again while
+dyld patching is pending, each time searched again for every pending patch. Pages searched
+without any match are marked in a bitmap per 16 MB region of the cache file, and are not
+searched again. Active patches are only ever retired, thus a page without any match for
+the patches pending when it was searched stays so. Regions are taken from a pool allocated
+on start and never released, once it is full further pages are searched as before.
+*/
+
+static inline size_t cleanRegionHash(uintptr_t file, uint32_t region) {
+    return static_cast<size_t>(((file ^ region) * 0x9E3779B97F4A7C15ULL) >> 32) & (kCleanRegionSlots - 1);
+}
+
+static CleanRegion *findCleanRegion(uintptr_t file, uint32_t vid, uint32_t region) {
+    size_t slot = cleanRegionHash(file, region);
+    for (size_t probe = 0; probe < kCleanRegionProbes; probe++) {
+        CleanRegion &entry = clean_regions[(slot + probe) & (kCleanRegionSlots - 1)];
+        uintptr_t entryFile = __atomic_load_n(&entry.file, __ATOMIC_ACQUIRE);
+        if (entryFile == 0) {
+            break;
+        }
+        if (entryFile == file && entry.vid == vid && entry.region == region) {
+            return &entry;
         }
     }
-    return res;
+    return nullptr;
 }
 
-// For Big Sur and newer
-static void patched_cs_validate_page(vnode_t vp, memory_object_t pager, memory_object_offset_t page_offset, const void *data, int *validated_p, int *tainted_p, int *nx_p) {
-    char path[PATH_MAX];
-    int pathlen = PATH_MAX;
-    FunctionCast(patched_cs_validate_page, orig_cs_validate)(vp, pager, page_offset, data, validated_p, tainted_p, nx_p);
+// clean_lock must be held
+static CleanRegion *insertCleanRegion(uintptr_t file, uint32_t vid, uint32_t region) {
+    size_t slot = cleanRegionHash(file, region);
+    for (size_t probe = 0; probe < kCleanRegionProbes; probe++) {
+        CleanRegion &entry = clean_regions[(slot + probe) & (kCleanRegionSlots - 1)];
+        if (entry.file == file && entry.vid == vid && entry.region == region) {
+            return &entry;
+        }
+        if (entry.file == 0) {
+            entry.vid = vid;
+            entry.region = region;
+            // Lookups run without the lock, publish the entry once complete
+            __atomic_store_n(&entry.file, file, __ATOMIC_RELEASE);
+            return &entry;
+        }
+    }
+    return nullptr;
+}
 
-    // If patch was successful, exit early
-    bool patch_result = false;
-    bool patch_result_tmp = false;
+// Whether every page of the validated range was searched before without any match
+static bool isCleanRange(uintptr_t file, uint32_t vid, memory_object_offset_t offset, size_t size) {
+    if (!clean_regions) {
+        return false;
+    }
+    for (uint64_t page = offset / PAGE_SIZE; page < (offset + size + PAGE_SIZE - 1) / PAGE_SIZE; page++) {
+        CleanRegion *entry = findCleanRegion(file, vid, static_cast<uint32_t>(page / kCleanRegionPages));
+        size_t bit = page % kCleanRegionPages;
+        if (!entry || (__atomic_load_n(&entry->pages[bit / 64], __ATOMIC_RELAXED) & (1ULL << (bit % 64))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    if (vn_getpath(vp, path, &pathlen) == 0) {
-        // dyld_shared_cache patching
-        if (UserPatcher::matchSharedCachePath(path)) {
-            // If we've already patched everything we can, exit early
-            if (number_of_loops >= total_allowed_loops) {
-                return;
+// Marks the pages searched in full within the validated range
+static void markCleanPages(uintptr_t file, uint32_t vid, memory_object_offset_t offset, size_t size) {
+    if (!clean_regions) {
+        return;
+    }
+    // Pages only partially validated were not searched in full
+    for (uint64_t page = (offset + PAGE_SIZE - 1) / PAGE_SIZE; page < (offset + size) / PAGE_SIZE; page++) {
+        uint32_t region = static_cast<uint32_t>(page / kCleanRegionPages);
+        CleanRegion *entry = findCleanRegion(file, vid, region);
+        if (!entry) {
+            IOSimpleLockLock(clean_lock);
+            entry = insertCleanRegion(file, vid, region);
+            IOSimpleLockUnlock(clean_lock);
+            if (!entry) {
+                continue;
             }
+        }
+        size_t bit = page % kCleanRegionPages;
+        __atomic_fetch_or(&entry->pages[bit / 64], 1ULL << (bit % 64), __ATOMIC_RELAXED);
+    }
+}
 
-            /*
-            Check if too much time has passed since start
-            We know the dyld patching should finish within 5 minutes, otherwise our patches
-            are likely between pages and will never apply (ie. wasted loops)
-            */
-            if (time_to_exit) {
-                return;
-            } else if (check_time_elapsed()) {
-                return;
-            }
-            
-            // Continuity Camera patch
-            if (!has_applied_continuity_patch && host_needs_continuity_patch) {
-                patch_result = searchAndPatchWithMask(data, PAGE_SIZE, path, kContinuityCameraOriginal, kContinuityCameraOriginalMask, kContinuityCameraPatched, kContinuityCameraPatchedMask, "Continuity Camera", true);
-                if (patch_result) {
-                    has_applied_continuity_patch = true;
-                    return;
-                }
-            }
+#pragma mark - Shared cache target ranges
 
-            // Night Shift patch
-            if (!disable_nightshift && os_supports_nightshift_new) {
-                if (host_needs_nightshift_patch && !has_applied_nightshift_patch) {
-                    patch_result = searchAndPatch(data, PAGE_SIZE, path, kNightShiftOriginal, kNightShiftPatched, "NightShift", true);
-                    if (patch_result) {
-                        has_applied_nightshift_patch = true;
-                        return;
-                    }
-                }
-            }
+/*
+Patch sets only live in a handful of shared cache images, listed by kCacheTargets, while
+every page of the multi-gigabyte cache is validated through the hook. The first time a cache
+file is seen, its header, image table and the load commands of the target images are read
+in the background to get the file ranges of their target sections. From then on pages
+outside of them are not scanned. Until the ranges are known, and for files that cannot be
+mapped, every page is scanned as before.
+Since macOS 12 the cache is split into a main cache file listing every image and sub cache
+files holding them. The main cache file tells which sub cache files hold the target images,
+the others are rejected as a whole, as are main cache files holding none of them. Sub cache
+files seen before their main cache wait for it to be mapped, being scanned meanwhile.
+The UniversalControl and ControlCenter binaries are mapped the same way, from the sections
+of their x86_64 slices listed by kBinaryTargetSections. As their patch sites, their ranges
+are kept by file rather than by vnode, the vnode may be recycled while the file stays.
+Slots are never released, once all are taken further files are scanned in full.
+The target lists are written by hand, thus the ranges of every mapped file are read once
+and searched for the patches. Binaries missing their patch are scanned in full. Once the
+main cache files and the sub caches holding target images are all mapped, a pending dyld
+patch matched fewer times than its quota across them has every shared cache page scanned
+from then on, one of its copies lives outside of the target images.
+*/
 
-            // Sidecar, AirPlay and Universal Control patches
-            if (!disable_sidecar_mac && (os_supports_sidecar || os_supports_airplay_to_mac || os_supports_universal_control || os_supports_airplay_to_mac_vmm_checks)) {
-                if (host_needs_airplay_to_mac_patch || host_needs_sidecar_patch || host_needs_universal_control_patch || host_needs_vmm_patch) {
-                    /* Note: VMM check may be inside the same page as the model check, thus don't return early
-                             when patch has been applied.
-                    */
-
-                    // Sidecar and AirPlay model checks
-                    if (model_is_MacBookPro_2012) {
-                        patch_result_tmp = searchAndPatch(data, PAGE_SIZE, path, kSideCarAirPlayMacBookPro2012Original, kSideCarAirPlayMacBookPro2012Patched, "Sidecar/AirPlay (MacBook Pro 2012)", true);
-                        if (patch_result_tmp) {
-                            patch_result = true;
-                        }
-                    } else if (model_is_MacBookPro_2013 || model_is_MacBookPro_2015) {
-                        patch_result_tmp = searchAndPatch(data, PAGE_SIZE, path, kSideCarAirPlayMacBookPro2013_2015Original, kSideCarAirPlayMacBookPro2013_2015Patched, "Sidecar/AirPlay (MacBook Pro 2013 - 2015)", true);
-                        if (patch_result_tmp) {
-                            patch_result = true;
-                        }
-                    } else if (model_is_MacBook_2015 || model_is_MacBookAir_2012) {
-                        patch_result_tmp = searchAndPatch(data, PAGE_SIZE, path, kSideCarAirPlayMacBookMacBookAir2012Original, kSideCarAirPlayMacBooMacBookAir2012Patched, "Sidecar/AirPlay (MacBook 2015/MacBook Air 2012)", true);
-                        if (patch_result_tmp) {
-                            patch_result = true;
-                        }
-                    } else if (model_is_MacBookAir_2013 || model_is_MacBookAir_2015) {
-                        patch_result_tmp = searchAndPatch(data, PAGE_SIZE, path, kSideCarAirPlayMacBookAir2013_2015Original, kSideCarAirPlayMacBookAir2013_2015Patched, "Sidecar/AirPlay (MacBook Air 2013 - 2015)", true);
-                        if (patch_result_tmp) {
-                            patch_result = true;
-                        }
-                    } else if (model_is_iMac_2012 || model_is_iMac_2013 || model_is_iMac_2014 || model_is_iMac_2015_broadwell) {
-                        if (model_is_iMac_2012) {
-                            patch_result_tmp = searchAndPatch(data, PAGE_SIZE, path, kSideCarAirPlayiMacAlternative2012Original, kSideCarAirPlayiMacAlternative2012Patched, "Sidecar/AirPlay (iMac 2012)", true);
-                            if (patch_result_tmp) {
-                                patch_result = true;
-                            }
-                        } else if (model_is_iMac_2013) {
-                            patch_result_tmp = searchAndPatch(data, PAGE_SIZE, path, kSideCarAirPlayiMacAlternative2013Original, kSideCarAirPlayiMacAlternative2013Patched, "Sidecar/AirPlay (iMac 2013)", true);
-                            if (patch_result_tmp) {
-                                patch_result = true;
-                            }
-                        } else if (model_is_iMac_2014 || model_is_iMac_2015_broadwell) {
-                            patch_result_tmp = searchAndPatch(data, PAGE_SIZE, path, kSideCarAirPlayiMacAlternative2014Original, kSideCarAirPlayiMacAlternative2014Patched, "Sidecar/AirPlay (iMac 2014)", true);
-                            if (patch_result_tmp) {
-                                patch_result = true;
-                            }
-                        }
-                    } else if (model_is_Macmini_2012 || model_is_Macmini_2014) {
-                        patch_result_tmp = searchAndPatch(data, PAGE_SIZE, path, kSideCarAirPlayMacminiOriginal, kSideCarAirPlayMacminiPatched, "Sidecar/AirPlay (Mac mini 2012 - 2014)", true);
-                        if (patch_result_tmp) {
-                            patch_result = true;
-                        }
-                    } else if (model_is_MacPro_2013 || model_is_MacPro_2010_2012) {
-                        patch_result_tmp = searchAndPatch(data, PAGE_SIZE, path, kSideCarAirPlayMacProOriginal, kSideCarAirPlayMacProPatched, "Sidecar/AirPlay (Mac Pro 2010 - 2013)", true);
-                        if (patch_result_tmp) {
-                            patch_result = true;
-                        }
-                    }
-                    else if (os_supports_airplay_to_mac && (model_is_MacBookPro_2016 || model_is_MacBookPro_2017 || model_is_iMac_2015_2017 || model_is_Macmini_2018)) {
-                        patch_result_tmp = searchAndPatch(data, PAGE_SIZE, path, kMacModelAirplayExtendedOriginal, kMacModelAirplayExtendedPatched, "AirPlay to Mac (Extended)", true);
-                        if (patch_result_tmp) {
-                            patch_result = true;
-                        }
-                    }
+struct CacheFile {
+    vnode_t vp;
+    vfs_context_t context;
+};
 
-                    // AirPlay to Mac VMM check
-                    if (os_supports_airplay_to_mac_vmm_checks && !has_applied_airplay_to_mac_vmm_patch) {
-                        if (host_needs_vmm_patch) {
-                            patch_result_tmp = searchAndPatch(data, PAGE_SIZE, path, kAirPlayVmmOriginal, kAirPlayVmmPatched, "AirPlay to Mac (VMM)", true);
-                            if (patch_result_tmp) {
-                                has_applied_airplay_to_mac_vmm_patch = true;
-                                patch_result = true;
-                            }
-                        }
-                    }
-                }
-                // Sidecar iPad check
-                if (allow_sidecar_ipad && !has_applied_iPad_sidecar_patch) {
-                    patch_result = searchAndPatch(data, PAGE_SIZE, path, kSidecariPadModelOriginal, kSidecariPadModelPatched, "Sidecar (iPad)", true);
-                    if (patch_result) {
-                        has_applied_iPad_sidecar_patch = true;
-                    }
-                }
+static bool readCacheFile(void *context, uint64_t offset, void *buffer, size_t size) {
+    auto file = static_cast<CacheFile *>(context);
+    return FileIO::readFileData(buffer, static_cast<off_t>(offset), size, file->vp, file->context) == 0;
+}
 
-                if (patch_result) {
-                    return;
-                }
+// Returns whether the layout is new, main cache files seen again through another vnode are recorded once
+static bool recordCacheLayout(const CacheLayout &layout) {
+    IOSimpleLockLock(cache_map_lock);
+    size_t count = cache_layout_count;
+    for (size_t i = 0; i < count; i++) {
+        if (memcmp(cache_layouts[i].subCaches[0].uuid, layout.subCaches[0].uuid, sizeof(layout.subCaches[0].uuid)) == 0) {
+            IOSimpleLockUnlock(cache_map_lock);
+            return false;
+        }
+    }
+    if (count < kCacheLayoutSlots) {
+        cache_layouts[count] = layout;
+        __atomic_store_n(&cache_layout_count, count + 1, __ATOMIC_RELEASE);
+    }
+    IOSimpleLockUnlock(cache_map_lock);
+    if (count == kCacheLayoutSlots) {
+        SYSLOG(MODULE_SHORT, "no room left for shared cache layout, its sub caches will be scanned in full");
+        return false;
+    }
+    return true;
+}
+
+// Patch bits found within the ranges of the file, matches are looked for in blocks overlapping by the longest pattern.
+// Dyld patch matches are counted in matches, those starting in the overlap are left to the next block.
+static uint32_t searchCacheRanges(CacheFile &file, PatchTarget target, const CacheRange *ranges, size_t count, uint8_t *block,
+                                  uint8_t (&matches)[kMaxMatchPatterns]) {
+    const MultiPatternMatcher &matcher = patch_config.dyldMatcher;
+    const PatchDescriptor *patch = target == PatchTarget::SharedCache ? nullptr : patch_config.binaryPatches[static_cast<size_t>(target)];
+    size_t overlap = 0;
+    if (patch) {
+        overlap = patch->size - 1;
+    } else {
+        for (size_t i = 0; i < matcher.size(); i++) {
+            if (matcher.pattern(i).size - 1 > overlap) {
+                overlap = matcher.pattern(i).size - 1;
             }
         }
-        // Individual binary patching
-        else {
-            // Universal Control.app patch
-            if (!disable_sidecar_mac && os_supports_universal_control && host_needs_universal_control_patch) {
-                if (UNLIKELY(strcmp(path, universalControlPath) == 0)) {
-                    patch_result = searchAndPatch(data, PAGE_SIZE, path, kUniversalControlFind, kUniversalControlReplace, "Universal Control (app)", false);
-                    if (patch_result) {
-                        return;
-                    }
-                }
+    }
+    uint32_t found = 0;
+    memset(matches, 0, sizeof(matches));
+    for (size_t i = 0; i < count; i++) {
+        for (uint64_t at = ranges[i].begin; at < ranges[i].end; at += kCacheSearchBlock - overlap) {
+            size_t size = ranges[i].end - at < kCacheSearchBlock ? static_cast<size_t>(ranges[i].end - at) : kCacheSearchBlock;
+            // Unreadable ranges leave their patches missing, falling back to a full scan
+            if (!readCacheFile(&file, at, block, size)) {
+                return found;
             }
-            if (!disable_sidecar_mac && host_needs_airplay_to_mac_vmm_patch) {
-                if (UNLIKELY(strcmp(path, controlCenterPath) == 0)) {
-                    patch_result = searchAndPatch(data, PAGE_SIZE, path, kGenericVmmOriginal, kGenericVmmPatched, "Control Center (app)", false);
-                    if (patch_result) {
-                        return;
+            bool last = at + size == ranges[i].end;
+            if (patch) {
+                found |= findPattern(block, size, 0, patch->pattern()) != SIZE_MAX ? 1 : 0;
+            } else {
+                size_t limit = last ? size : size - overlap;
+                found |= matcher.scan(block, size, patch_config.dyldPatchMask, [&](size_t index, size_t offset) {
+                    if (offset < limit && matches[index] < UINT8_MAX) {
+                        matches[index]++;
                     }
-                }
+                });
+            }
+            if (last) {
+                break;
             }
         }
     }
+    return found;
 }
 
-#pragma mark - Detect Model
-
-static void detectMachineProperties() {
-    // Detect Hypervisor
-    size_t vmm_present_size = sizeof(host_needs_vmm_patch);
-    if (sysctlbyname("kern.hv_vmm_present", &host_needs_vmm_patch, &vmm_present_size, NULL, 0) == 0) {
-        if (host_needs_vmm_patch == 1) {
-            DBGLOG(MODULE_SHORT, "Detected VMM system");
+// Whether a sub cache flagged by a layout has yet to be mapped
+static bool isCacheTargetPending(const CacheSubCache &subCache) {
+    for (auto &map : cache_maps) {
+        if (__atomic_load_n(&map.file, __ATOMIC_ACQUIRE) == 0) {
+            break;
+        }
+        if (map.target == PatchTarget::SharedCache && __atomic_load_n(&map.state, __ATOMIC_ACQUIRE) == CacheMapState::Filtered &&
+            memcmp(map.uuid, subCache.uuid, sizeof(subCache.uuid)) == 0) {
+            return false;
         }
     }
+    return true;
+}
 
-    // Detect model
-    // Function will return once a match is found
-    auto deviceInfo = BaseDeviceInfo::get();
-    SYSLOG(MODULE_SHORT, "Host model detected: %s", deviceInfo.modelIdentifier);
-
-    // Sometimes the model can have garbage on the end, so partial matches are used
-    // ex. MacBookPro13,1DvcPtsupre
-    if (strstr(deviceInfo.modelIdentifier, "Book", sizeof("Book")-1)) {
-        if (strstr(deviceInfo.modelIdentifier, "Pro", sizeof("Pro")-1)) {
-            // MacBook Pro
-            for (size_t i = 0; i < arrsize(macbookpro_legacy_models); i++) {
-                if (strncmp(deviceInfo.modelIdentifier, macbookpro_legacy_models[i], strlen(macbookpro_legacy_models[i])) == 0) {
-                    model_is_MacBookPro_pre_2012 = true;
-                    DBGLOG(MODULE_SHORT, "Detected legacy MacBookPro model");
-                    return;
-                }
+// Scans every shared cache page once the mapped target images hold fewer matches of a pending dyld patch than its quota
+static void checkCacheTargets() {
+    uint32_t pending = __atomic_load_n(&patch_progress.pending, __ATOMIC_RELAXED);
+    if (!__atomic_load_n(&cache_map_fallback, __ATOMIC_RELAXED)) {
+        uint32_t matches[kMaxMatchPatterns] {};
+        bool filtered = false;
+        for (auto &map : cache_maps) {
+            if (__atomic_load_n(&map.file, __ATOMIC_ACQUIRE) == 0) {
+                break;
             }
-            for (size_t i = 0; i < arrsize(macbookpro_2012_models); i++) {
-                if (strncmp(deviceInfo.modelIdentifier, macbookpro_2012_models[i], strlen(macbookpro_2012_models[i])) == 0) {
-                    model_is_MacBookPro_2012 = true;
-                    DBGLOG(MODULE_SHORT, "Detected MacBookPro 2012 model");
-                    return;
-                }
+            if (map.target != PatchTarget::SharedCache) {
+                continue;
             }
-            for (size_t i = 0; i < arrsize(macbookpro_2013_models); i++) {
-                if (strncmp(deviceInfo.modelIdentifier, macbookpro_2013_models[i], strlen(macbookpro_2013_models[i])) == 0) {
-                    model_is_MacBookPro_2013 = true;
-                    DBGLOG(MODULE_SHORT, "Detected MacBookPro 2013 model");
-                    return;
-                }
+            CacheMapState state = __atomic_load_n(&map.state, __ATOMIC_ACQUIRE);
+            if (state == CacheMapState::Pending || state == CacheMapState::Mapping) {
+                return;
             }
-            for (size_t i = 0; i < arrsize(macbookpro_2015_models); i++) {
-                if (strncmp(deviceInfo.modelIdentifier, macbookpro_2015_models[i], strlen(macbookpro_2015_models[i])) == 0) {
-                    model_is_MacBookPro_2015 = true;
-                    DBGLOG(MODULE_SHORT, "Detected MacBookPro 2015 model");
-                    return;
-                }
+            filtered |= state == CacheMapState::Filtered;
+            for (size_t i = 0; i < kMaxMatchPatterns; i++) {
+                matches[i] += map.matches[i];
             }
-            for (size_t i = 0; i < arrsize(macbookpro_2016_models); i++) {
-                if (strncmp(deviceInfo.modelIdentifier, macbookpro_2016_models[i], strlen(macbookpro_2016_models[i])) == 0) {
-                    model_is_MacBookPro_2016 = true;
-                    DBGLOG(MODULE_SHORT, "Detected MacBookPro 2016 model");
+        }
+        if (!filtered) {
+            return;
+        }
+        size_t layoutCount = __atomic_load_n(&cache_layout_count, __ATOMIC_ACQUIRE);
+        for (size_t l = 0; l < layoutCount; l++) {
+            for (size_t s = 0; s < cache_layouts[l].subCacheCount; s++) {
+                if (cache_layouts[l].subCaches[s].target && isCacheTargetPending(cache_layouts[l].subCaches[s])) {
                     return;
                 }
             }
-            for (size_t i = 0; i < arrsize(macbookpro_2017_models); i++) {
-                if (strncmp(deviceInfo.modelIdentifier, macbookpro_2017_models[i], strlen(macbookpro_2017_models[i])) == 0) {
-                    model_is_MacBookPro_2017 = true;
-                    DBGLOG(MODULE_SHORT, "Detected MacBookPro 2017 model");
-                    return;
-                }
+        }
+        // Patches with copies outside of the target images are found only in part
+        uint32_t missing = 0;
+        for (uint32_t bits = pending; bits != 0; bits &= bits - 1) {
+            size_t index = __builtin_ctz(bits);
+            if (matches[index] < patch_config.dyldPatches[index].quota) {
+                missing |= 1U << index;
             }
-        // MacBook Air
-        } else if (strstr(deviceInfo.modelIdentifier, "Air", sizeof("Air")-1)) {
-            for (size_t i = 0; i < arrsize(macbookair_legacy_models); i++) {
-                if (strncmp(deviceInfo.modelIdentifier, macbookair_legacy_models[i], strlen(macbookair_legacy_models[i])) == 0) {
-                    model_is_MacBookAir_pre_2012 = true;
-                    DBGLOG(MODULE_SHORT, "Detected legacy MacBookAir model");
-                    return;
-                }
+        }
+        if (missing == 0) {
+            return;
+        }
+        bool expected = false;
+        if (__atomic_compare_exchange_n(&cache_map_fallback, &expected, true, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            DBGLOG(MODULE_SHORT, "pending patches 0x%x short of their matches in the target images, scanning every shared cache page", missing);
+        }
+    }
+    // Files mapped concurrently are caught by the call mapping them
+    for (auto &map : cache_maps) {
+        if (__atomic_load_n(&map.file, __ATOMIC_ACQUIRE) == 0) {
+            break;
+        }
+        CacheMapState state = CacheMapState::Filtered;
+        if (map.target == PatchTarget::SharedCache) {
+            __atomic_compare_exchange_n(&map.state, &state, CacheMapState::Unfiltered, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void mapSharedCaches(thread_call_param_t, thread_call_param_t) {
+    CacheMapScratch *scratch = Buffer::create<CacheMapScratch>(1);
+    uint8_t *block = Buffer::create<uint8_t>(kCacheSearchBlock);
+    bool again = scratch != nullptr && block != nullptr;
+    while (again) {
+        // Sub caches waiting for their main cache are retried once it was mapped
+        bool recorded = false;
+        bool waiting = false;
+        for (auto &map : cache_maps) {
+            if (__atomic_load_n(&map.file, __ATOMIC_ACQUIRE) == 0) {
+                break;
             }
-            for (size_t i = 0; i < arrsize(macbookair_2012_models); i++) {
-                if (strncmp(deviceInfo.modelIdentifier, macbookair_2012_models[i], strlen(macbookair_2012_models[i])) == 0) {
-                    model_is_MacBookAir_2012 = true;
-                    DBGLOG(MODULE_SHORT, "Detected MacBookAir 2012 model");
-                    return;
-                }
+            // Calls entered again while running may run concurrently, the slot goes to whichever claims it
+            CacheMapState state = CacheMapState::Pending;
+            if (!__atomic_compare_exchange_n(&map.state, &state, CacheMapState::Mapping, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                continue;
             }
-            for (size_t i = 0; i < arrsize(macbookair_2013_models); i++) {
-                if (strncmp(deviceInfo.modelIdentifier, macbookair_2013_models[i], strlen(macbookair_2013_models[i])) == 0) {
-                    model_is_MacBookAir_2013 = true;
-                    DBGLOG(MODULE_SHORT, "Detected MacBookAir 2013 model");
-                    return;
+            CacheMapStatus status = CacheMapStatus::Malformed;
+            size_t count = 0;
+            uint32_t found = 0;
+            vnode_t vp = map.vp;
+            scratch->layout.subCacheCount = 0;
+            // Vnodes may be recycled meanwhile, the vid tells
+            if (vnode_getwithvid(vp, map.vpVid) == 0) {
+                CacheFile file {vp, vfs_context_create(nullptr)};
+                size_t size = FileIO::readFileSize(vp, file.context);
+                if (map.target == PatchTarget::SharedCache) {
+                    status = mapCacheTargets(readCacheFile, &file, size, kCacheTargets, cache_layouts, __atomic_load_n(&cache_layout_count, __ATOMIC_ACQUIRE),
+                                             *scratch, map.ranges, count, kMaxCacheMapRanges);
+                } else {
+                    status = mapMachTargets(readCacheFile, &file, size, kBinaryTargetSections, arrsize(kBinaryTargetSections), *scratch, map.ranges, count,
+                                            kMaxCacheMapRanges);
                 }
-            }
-            for (size_t i = 0; i < arrsize(macbookair_2015_models); i++) {
-                if (strncmp(deviceInfo.modelIdentifier, macbookair_2015_models[i], strlen(macbookair_2015_models[i])) == 0) {
-                    model_is_MacBookAir_2015 = true;
-                    DBGLOG(MODULE_SHORT, "Detected MacBookAir 2015 model");
-                    return;
+                if (status == CacheMapStatus::Mapped) {
+                    found = searchCacheRanges(file, map.target, map.ranges, count, block, map.matches);
                 }
+                vfs_context_rele(file.context);
+                vnode_put(vp);
             }
-        } else {
-            // MacBook
-            for (size_t i = 0; i < arrsize(macbook_legacy_models); i++) {
-                if (strncmp(deviceInfo.modelIdentifier, macbook_legacy_models[i], strlen(macbook_legacy_models[i])) == 0) {
-                    model_is_MacBook_pre_2015 = true;
-                    DBGLOG(MODULE_SHORT, "Detected legacy MacBook model");
-                    return;
-                }
+            if (scratch->layout.subCacheCount > 0 && recordCacheLayout(scratch->layout)) {
+                recorded = true;
             }
-            for (size_t i = 0; i < arrsize(macbook_modern_models); i++) {
-                if (strncmp(deviceInfo.modelIdentifier, macbook_modern_models[i], strlen(macbook_modern_models[i])) == 0) {
-                    model_is_MacBook_2015 = true;
-                    DBGLOG(MODULE_SHORT, "Detected MacBook 2015 model");
-                    return;
-                }
+            map.count = static_cast<uint8_t>(count);
+            map.found = found;
+            bool cache = map.target == PatchTarget::SharedCache;
+            if (cache) {
+                memcpy(map.uuid, scratch->header + kDyldCacheUuidOffset, sizeof(map.uuid));
             }
-        }
-    } else if (strstr(deviceInfo.modelIdentifier, "mini", sizeof("mini")-1)) {
-        // Mac mini
-        for (size_t i = 0; i < arrsize(macmini_legacy_models); i++) {
-            if (strncmp(deviceInfo.modelIdentifier, macmini_legacy_models[i], strlen(macmini_legacy_models[i])) == 0) {
-                model_is_Macmini_pre_2012 = true;
-                DBGLOG(MODULE_SHORT, "Detected legacy Mac mini model");
-                return;
+            CacheMapState mapped = CacheMapState::Unfiltered;
+            if (status == CacheMapStatus::SubCache) {
+                mapped = CacheMapState::Pending;
+                waiting = true;
+            } else if (cache && __atomic_load_n(&cache_map_fallback, __ATOMIC_RELAXED)) {
+                // Mapped after the fallback, see checkCacheTargets
+            } else if (!cache && status == CacheMapStatus::Mapped && found == 0) {
+                DBGLOG(MODULE_SHORT, "patch not found in the target sections of file %lu, scanning every page", static_cast<unsigned long>(&map - cache_maps));
+            } else if (status == CacheMapStatus::Mapped || status == CacheMapStatus::NoTargets) {
+                mapped = CacheMapState::Filtered;
             }
+            __atomic_store_n(&map.state, mapped, __ATOMIC_RELEASE);
+            DBGLOG(MODULE_SHORT, "target file %lu (%u) mapped with status %u, %lu ranges, patches 0x%x found", static_cast<unsigned long>(&map - cache_maps),
+                   static_cast<unsigned>(map.target), static_cast<unsigned>(status), static_cast<unsigned long>(count), found);
         }
-        for (size_t i = 0; i < arrsize(macmini_2012_models); i++) {
-            if (strncmp(deviceInfo.modelIdentifier, macmini_2012_models[i], strlen(macmini_2012_models[i])) == 0) {
-                model_is_Macmini_2012 = true;
-                DBGLOG(MODULE_SHORT, "Detected Mac mini 2012 model");
-                return;
-            }
+        again = recorded && waiting;
+    }
+    if (scratch && block) {
+        checkCacheTargets();
+    } else {
+        SYSLOG(MODULE_SHORT, "failed to allocate shared cache map buffers");
+    }
+    if (scratch) {
+        Buffer::deleter(scratch);
+    }
+    if (block) {
+        Buffer::deleter(block);
+    }
+}
+
+static void requestCacheMap(vnode_t vp, uintptr_t file, uint32_t vid, PatchTarget target) {
+    CacheMap *slot = nullptr;
+    IOSimpleLockLock(cache_map_lock);
+    for (auto &map : cache_maps) {
+        if (map.file == file && map.vid == vid) {
+            break;
         }
-        for (size_t i = 0; i < arrsize(macmini_2014_models); i++) {
-            if (strncmp(deviceInfo.modelIdentifier, macmini_2014_models[i], strlen(macmini_2014_models[i])) == 0) {
-                model_is_Macmini_2014 = true;
-                DBGLOG(MODULE_SHORT, "Detected Mac mini 2014 model");
-                return;
-            }
+        if (map.file == 0) {
+            slot = &map;
+            slot->vid = vid;
+            slot->vp = vp;
+            slot->vpVid = vnode_vid(vp);
+            slot->target = target;
+            slot->state = CacheMapState::Pending;
+            // Lookups run without the lock, publish the entry once complete
+            __atomic_store_n(&slot->file, file, __ATOMIC_RELEASE);
+            break;
         }
-        for (size_t i = 0; i < arrsize(macmini_2018_models); i++) {
-            if (strncmp(deviceInfo.modelIdentifier, macmini_2018_models[i], strlen(macmini_2018_models[i])) == 0) {
-                model_is_Macmini_2018 = true;
-                DBGLOG(MODULE_SHORT, "Detected Mac mini 2018 model");
-                return;
-            }
+    }
+    IOSimpleLockUnlock(cache_map_lock);
+    if (slot) {
+        thread_call_enter(cache_map_call);
+    }
+}
+
+// Whether the validated range may hold a match, the file is mapped in the background on first sight
+static bool isCacheTargetRange(vnode_t vp, uintptr_t file, uint32_t vid, PatchTarget target, memory_object_offset_t offset, size_t size) {
+    if (!cache_map_call) {
+        return true;
+    }
+    for (auto &map : cache_maps) {
+        uintptr_t mapFile = __atomic_load_n(&map.file, __ATOMIC_ACQUIRE);
+        if (mapFile == 0) {
+            break;
+        }
+        if (mapFile != file || map.vid != vid) {
+            continue;
+        }
+        if (__atomic_load_n(&map.state, __ATOMIC_ACQUIRE) != CacheMapState::Filtered) {
+            return true;
+        }
+        return intersectsCacheRanges(map.ranges, map.count, offset, size);
+    }
+    requestCacheMap(vp, file, vid, target);
+    return true;
+}
+
+#pragma mark - Kernel patching code
+
+// Offset of the first match of patch at or after from, SIZE_MAX when there is none
+template <MatchEngine Engine>
+static inline size_t findPatch(const uint8_t *data, size_t size, size_t from, const MatchPattern &pattern, const PatchDescriptor &patch);
+
+template <>
+inline size_t findPatch<MatchEngine::Anchor>(const uint8_t *data, size_t size, size_t from, const MatchPattern &pattern, const PatchDescriptor &) {
+    return findPattern(data, size, from, pattern);
+}
+
+template <>
+inline size_t findPatch<MatchEngine::Horspool>(const uint8_t *data, size_t size, size_t from, const MatchPattern &pattern, const PatchDescriptor &patch) {
+    return SkipSearch(pattern, *patch.skip).search(data, size, from);
+}
+
+template <MatchEngine Engine>
+static inline bool searchAndPatch(vnode_t vp, VnodeClass cls, memory_object_offset_t offset, const void *haystack, size_t haystackSize, const PatchDescriptor &patch, HookTimer &timer) {
+    uint8_t *data = static_cast<uint8_t *>(const_cast<void *>(haystack));
+    const MatchPattern pattern = patch.pattern();
+    // Most pages hold neither anchor byte pair nor the pattern, skip the full search for them
+    bool candidate = Engine == MatchEngine::Horspool || hasAnchorCandidate(data, haystackSize, patch.find, patch.size, patch.anchor);
+    size_t at = candidate ? findPatch<Engine>(data, haystackSize, 0, pattern, patch) : SIZE_MAX;
+    uint64_t spent = timer.lap(LatencyPhase::Scan);
+    bool found = at != SIZE_MAX;
+    uint32_t matches = 0;
+    if (UNLIKELY(found)) {
+        uint32_t vid;
+        uintptr_t file = patchSiteFile(vp, cls, vid);
+        while (at != SIZE_MAX) {
+            DBGLOG(MODULE_SHORT, "found function %s to patch at 0x%llx!", patch.name, static_cast<unsigned long long>(offset + at));
+            applyPattern(data + at, pattern, 0, patch.size);
+            recordPatchSite(file, vid, offset + at, patch, offset, offset + haystackSize);
+            matches++;
+            at = findPatch<Engine>(data, haystackSize, at + patch.size, pattern, patch);
         }
+        spent += timer.lap(LatencyPhase::Patch);
+    }
+    statsCountPatch(patch, haystackSize, matches, found, spent);
+    return found;
+}
 
-    } else if (strstr(deviceInfo.modelIdentifier, "Pro", sizeof("Pro")-1)) {
-        // Mac Pro
-        for (size_t i = 0; i < arrsize(macpro_legacy_models); i++) {
-            if (strncmp(deviceInfo.modelIdentifier, macpro_legacy_models[i], strlen(macpro_legacy_models[i])) == 0) {
-                model_is_MacPro_pre_2013 = true;
-                DBGLOG(MODULE_SHORT, "Detected legacy Mac Pro model");
-                for (size_t i = 0; i < arrsize(macpro_2010_2012_models); i++) {
-                    if (strncmp(deviceInfo.modelIdentifier, macpro_2010_2012_models[i], strlen(macpro_2010_2012_models[i])) == 0) {
-                        model_is_MacPro_2010_2012 = true;
-                        DBGLOG(MODULE_SHORT, "Detected Mac Pro 2010-2012 model");
-                        return;
-                    }
-                }
-                return;
-            }
+static inline bool searchAndPatch(vnode_t vp, VnodeClass cls, memory_object_offset_t offset, const void *haystack, size_t haystackSize, const PatchDescriptor &patch, HookTimer &timer) {
+    return patch.engine == MatchEngine::Horspool ?
+        searchAndPatch<MatchEngine::Horspool>(vp, cls, offset, haystack, haystackSize, patch, timer) :
+        searchAndPatch<MatchEngine::Anchor>(vp, cls, offset, haystack, haystackSize, patch, timer);
+}
+
+static inline void finishHookWork(HookWork work) {
+    uint32_t left = __atomic_and_fetch(&patch_progress.work, ~static_cast<uint32_t>(work), __ATOMIC_RELAXED);
+    if (left == 0) {
+        DBGLOG(MODULE_SHORT, "Nothing left to patch, validation hook bypassed");
+    }
+}
+
+static inline bool dyldPatchingExpired() {
+    if (LIKELY(!__atomic_load_n(&patch_progress.expired, __ATOMIC_RELAXED))) {
+        if (LIKELY(mach_absolute_time() < patch_config.deadline)) {
+            return false;
         }
-        for (size_t i = 0; i < arrsize(macpro_2013_models); i++) {
-            if (strncmp(deviceInfo.modelIdentifier, macpro_2013_models[i], strlen(macpro_2013_models[i])) == 0) {
-                model_is_MacPro_2013 = true;
-                DBGLOG(MODULE_SHORT, "Detected Mac Pro 2013 model");
-                return;
-            }
+        // Only the first CPU past the deadline reports it
+        if (!__atomic_exchange_n(&patch_progress.expired, true, __ATOMIC_RELAXED)) {
+            DBGLOG(MODULE_SHORT, "Dyld patching deadline passed with %u of %u loops, exiting",
+                   __atomic_load_n(&patch_progress.loops, __ATOMIC_RELAXED), patch_config.allowedLoops);
+            finishHookWork(HookWorkDyld);
         }
-    } else if (strstr(deviceInfo.modelIdentifier, "iMac", sizeof("iMac")-1)) {
-        // iMac
-        for (size_t i = 0; i < arrsize(imac_legacy_models); i++) {
-            if (strncmp(deviceInfo.modelIdentifier, imac_legacy_models[i], strlen(imac_legacy_models[i])) == 0) {
-                model_is_iMac_pre_2012 = true;
-                DBGLOG(MODULE_SHORT, "Detected legacy iMac model");
-                return;
-            }
+    }
+    return true;
+}
+
+static inline bool dyldPatchingDone() {
+    return (__atomic_load_n(&patch_progress.work, __ATOMIC_RELAXED) & HookWorkDyld) == 0;
+}
+
+SYSCTL_UINT(_kern_featureunlock, OID_AUTO, dyld_loops, CTLFLAG_RD | CTLFLAG_LOCKED,
+            &patch_progress.loops, 0, "Dyld patch matches counted so far");
+SYSCTL_UINT(_kern_featureunlock, OID_AUTO, dyld_allowed_loops, CTLFLAG_RD | CTLFLAG_LOCKED,
+            &patch_config.allowedLoops, 0, "Dyld patch matches expected on this host");
+
+static void registerProgressSysctl() {
+    sysctl_register_oid(&sysctl__kern_featureunlock_dyld_loops);
+    sysctl_register_oid(&sysctl__kern_featureunlock_dyld_allowed_loops);
+}
+
+#pragma mark - Vnode classification
+
+/*
+The hook runs for every validated page of every signed binary, while only a handful
+of files are of interest. Classification of a vnode is cached so that vn_getpath is
+called once per file rather than once per page.
+Every slot is guarded by a sequence counter. Readers never block or retry, a slot
+being written is simply treated as a miss. Writers losing the race for a slot skip
+caching, the next validation of the vnode classifies it again.
+*/
+
+static inline size_t vnodeCacheHash(vnode_t vp) {
+    return static_cast<size_t>((reinterpret_cast<uintptr_t>(vp) * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+static VnodeClass lookupVnodeClass(vnode_t vp, uint32_t vid) {
+    size_t hash = vnodeCacheHash(vp);
+    for (size_t probe = 0; probe < kVnodeCacheProbes; probe++) {
+        VnodeCacheEntry &entry = vnode_cache[(hash + probe) & (kVnodeCacheSlots - 1)];
+        uint32_t seq = __atomic_load_n(&entry.seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) {
+            continue;
         }
-        for (size_t i = 0; i < arrsize(imac_2012_models); i++) {
-            if (strncmp(deviceInfo.modelIdentifier, imac_2012_models[i], strlen(imac_2012_models[i])) == 0) {
-                model_is_iMac_2012 = true;
-                DBGLOG(MODULE_SHORT, "Detected iMac 2012 model");
-                return;
-            }
+        vnode_t entryVp = __atomic_load_n(&entry.vp, __ATOMIC_RELAXED);
+        uint32_t entryVid = __atomic_load_n(&entry.vid, __ATOMIC_RELAXED);
+        VnodeClass entryCls = __atomic_load_n(&entry.cls, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&entry.seq, __ATOMIC_RELAXED) != seq) {
+            continue;
         }
-        for (size_t i = 0; i < arrsize(imac_2013_models); i++) {
-            if (strncmp(deviceInfo.modelIdentifier, imac_2013_models[i], strlen(imac_2013_models[i])) == 0) {
-                model_is_iMac_2013 = true;
-                DBGLOG(MODULE_SHORT, "Detected iMac 2013 model");
-                return;
+        if (entryVp == vp && entryVid == vid) {
+            return entryCls;
+        }
+    }
+    return VnodeClass::Unknown;
+}
+
+static void storeVnodeClass(vnode_t vp, uint32_t vid, VnodeClass cls) {
+    size_t hash = vnodeCacheHash(vp);
+    // Prefer the slot already owned by this vnode, then an empty one, otherwise evict by vid
+    VnodeCacheEntry *victim = &vnode_cache[(hash + vid % kVnodeCacheProbes) & (kVnodeCacheSlots - 1)];
+    for (size_t probe = 0; probe < kVnodeCacheProbes; probe++) {
+        VnodeCacheEntry &entry = vnode_cache[(hash + probe) & (kVnodeCacheSlots - 1)];
+        vnode_t entryVp = __atomic_load_n(&entry.vp, __ATOMIC_RELAXED);
+        if (entryVp == vp) {
+            victim = &entry;
+            break;
+        }
+        if (entryVp == nullptr && victim->vp != nullptr) {
+            victim = &entry;
+        }
+    }
+
+    uint32_t seq = __atomic_load_n(&victim->seq, __ATOMIC_RELAXED);
+    if ((seq & 1) || !__atomic_compare_exchange_n(&victim->seq, &seq, seq + 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        return;
+    }
+    __atomic_store_n(&victim->vp, vp, __ATOMIC_RELAXED);
+    __atomic_store_n(&victim->vid, vid, __ATOMIC_RELAXED);
+    __atomic_store_n(&victim->cls, cls, __ATOMIC_RELAXED);
+    __atomic_store_n(&victim->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/*
+Targets live on very few volumes: the sealed system volume, the Preboot cryptex on
+Ventura and newer, or the Data volume for shared caches before Big Sur. The mount of a
+target is recorded when its path is first resolved. Once every target class patched on
+this host was found, vnodes of any other mount are rejected with a few pointer compares
+before the classification cache, thus files of app bundles and third-party frameworks
+never reach vn_getpath. Every target class is expected to stay on the mount it was found on.
+*/
+
+static void recordTargetMount(vnode_t vp, VnodeClass cls) {
+    uint32_t bit = vnodeClassBit(cls);
+    if ((patch_config.targetClasses & bit) == 0) {
+        return;
+    }
+    mount_t mount = vnode_mount(vp);
+    for (auto &target : target_mounts) {
+        mount_t expected = nullptr;
+        if (__atomic_compare_exchange_n(&target, &expected, mount, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED) || expected == mount) {
+            // Publishes the mount along with the class
+            uint32_t found = __atomic_fetch_or(&target_mount_classes, bit, __ATOMIC_RELEASE);
+            if ((found & bit) == 0 && (found | bit) == patch_config.targetClasses) {
+                DBGLOG(MODULE_SHORT, "every target mount found, other mounts are rejected");
             }
+            return;
         }
-        for (size_t i = 0; i < arrsize(imac_2014_models); i++) {
-            if (strncmp(deviceInfo.modelIdentifier, imac_2014_models[i], strlen(imac_2014_models[i])) == 0) {
-                model_is_iMac_2014 = true;
-                DBGLOG(MODULE_SHORT, "Detected iMac 2014 model");
-                return;
+    }
+    SYSLOG(MODULE_SHORT, "too many target mounts, mounts are not rejected");
+    __atomic_fetch_or(&target_mount_classes, kTargetMountsOverflow, __ATOMIC_RELAXED);
+}
+
+static inline bool rejectVnodeMount(vnode_t vp) {
+    if (__atomic_load_n(&target_mount_classes, __ATOMIC_ACQUIRE) != patch_config.targetClasses) {
+        return false;
+    }
+    mount_t mount = vnode_mount(vp);
+    for (auto &target : target_mounts) {
+        if (__atomic_load_n(&target, __ATOMIC_RELAXED) == mount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Other shared cache variants are never mapped by userspace, DriverKit caches share the name of the system ones
+static bool isActiveSharedCache(const char *path) {
+    const char *name = patch_config.sharedCacheName;
+    if (!name) {
+        return true;
+    }
+    if (strstr(path, "/DriverKit/")) {
+        return false;
+    }
+    const char *file = strrchr(path, '/');
+    file = file ? file + 1 : path;
+    size_t length = strlen(name);
+    // Sub caches append a suffix to the name of their main cache
+    return strncmp(file, name, length) == 0 && (file[length] == '\0' || file[length] == '.');
+}
+
+static VnodeClass classifyVnode(vnode_t vp) {
+    if (LIKELY(rejectVnodeMount(vp))) {
+        return VnodeClass::Irrelevant;
+    }
+    uint32_t vid = vnode_vid(vp);
+    VnodeClass cls = lookupVnodeClass(vp, vid);
+    if (LIKELY(cls != VnodeClass::Unknown)) {
+        return cls;
+    }
+
+    char path[PATH_MAX];
+    int pathlen = PATH_MAX;
+    if (vn_getpath(vp, path, &pathlen) != 0) {
+        return VnodeClass::Unknown;
+    }
+    if (UserPatcher::matchSharedCachePath(path)) {
+        cls = isActiveSharedCache(path) ? VnodeClass::SharedCache : VnodeClass::Irrelevant;
+    } else if (strcmp(path, universalControlPath) == 0) {
+        cls = VnodeClass::UniversalControl;
+    } else if (strcmp(path, controlCenterPath) == 0) {
+        cls = VnodeClass::ControlCenter;
+    } else {
+        cls = VnodeClass::Irrelevant;
+    }
+    if (cls != VnodeClass::Irrelevant) {
+        recordTargetMount(vp, cls);
+    }
+    storeVnodeClass(vp, vid, cls);
+    return cls;
+}
+
+#pragma mark - Dyld patching
+
+static void recordDyldPatch(size_t index, vnode_t vp) {
+    const DyldPatch &patch = patch_config.dyldPatches[index];
+    // Several CPUs may apply a one-shot patch to different pages at once, the one clearing its bit accounts it
+    uint32_t bit = 1U << index;
+    uint32_t pending = 0;
+    if (patch.desc->oneShot && ((pending = __atomic_fetch_and(&patch_progress.pending, ~bit, __ATOMIC_RELAXED)) & bit) == 0) {
+        return;
+    }
+#ifdef DEBUG
+    // Path is no longer resolved in the hook, only look it up for logging
+    char path[PATH_MAX];
+    int pathlen = PATH_MAX;
+    if (vn_getpath(vp, path, &pathlen) != 0) {
+        path[0] = '\0';
+    }
+    DBGLOG(MODULE_SHORT, "found function %s to patch at %s!", patch.desc->name, path);
+#else
+    (void)vp;
+#endif
+    // Extra matches of a patch do not make up for another one still missing
+    if (__atomic_add_fetch(&patch_progress.hits[index], 1, __ATOMIC_RELAXED) > patch.quota) {
+        return;
+    }
+    uint32_t loops = __atomic_add_fetch(&patch_progress.loops, 1, __ATOMIC_RELAXED);
+    DBGLOG(MODULE_SHORT, "number of loops: %u", loops);
+    // Completion follows the active patches, either every expected match was counted or nothing is looked for anymore
+    if (loops == patch_config.allowedLoops || (patch.desc->oneShot && pending == bit)) {
+        DBGLOG(MODULE_SHORT, "Reached maximum loops (%u), no more dyld patching", patch_config.allowedLoops);
+        finishHookWork(HookWorkDyld);
+    }
+}
+
+#pragma mark - Page boundary handling
+
+/*
+Needles may straddle two pages, in which case neither page matches on its own.
+Edges of recently validated pages are kept so that whichever page of a pair is
+validated second can detect the split match. That page is patched right away,
+while the half living in the already validated page is recorded as a re-page site
+and applied the next time that page is validated.
+A split match only counts as applied once that site is written: until then the page
+validated first keeps its original bytes, the patch stays pending and the deadline
+still applies. Pages that are never validated again leave the match half patched,
+there is no way to patch a page already handed out.
+Every scanned page exchanges its edges under a single hold of boundary_lock.
+*/
+
+// boundary_lock must be held
+static bool takeBoundaryEdge(vnode_t vp, uint32_t vid, memory_object_offset_t offset, bool head, uint8_t *bytes, size_t &size) {
+    bool found = false;
+    for (size_t i = 0; i < kBoundarySlots; i++) {
+        BoundaryEdge &edge = boundary_edges[i];
+        if (edge.vp == vp && edge.vid == vid && edge.offset == offset && edge.head == head) {
+            size = edge.size;
+            memcpy(bytes, edge.bytes, size);
+            edge.vp = nullptr;
+            found = true;
+            break;
+        }
+    }
+    return found;
+}
+
+// boundary_lock must be held
+static void storeBoundaryEdge(vnode_t vp, uint32_t vid, memory_object_offset_t offset, bool head, const uint8_t *bytes, size_t size) {
+    BoundaryEdge *slot = nullptr;
+    for (size_t i = 0; i < kBoundarySlots; i++) {
+        BoundaryEdge &edge = boundary_edges[i];
+        if (edge.vp == vp && edge.vid == vid && edge.offset == offset && edge.head == head) {
+            slot = &edge;
+            break;
+        }
+    }
+    // Oldest edge is evicted, only pages validated close in time are expected to pair up
+    if (!slot) {
+        slot = &boundary_edges[boundary_edge_next];
+        boundary_edge_next = (boundary_edge_next + 1) % kBoundarySlots;
+    }
+    slot->vp = vp;
+    slot->vid = vid;
+    slot->offset = offset;
+    slot->head = head;
+    slot->size = static_cast<uint8_t>(size);
+    memcpy(slot->bytes, bytes, size);
+}
+
+static void scanDyldPage(vnode_t vp, memory_object_offset_t offset, const void *data, size_t size, HookTimer &timer) {
+    uint8_t *bytes = static_cast<uint8_t *>(const_cast<void *>(data));
+    const MultiPatternMatcher &matcher = patch_config.dyldMatcher;
+    uint32_t enabled = __atomic_load_n(&patch_progress.pending, __ATOMIC_RELAXED);
+
+    uint32_t vid = vnode_vid(vp);
+    uintptr_t file = reinterpret_cast<uintptr_t>(vp);
+    // Pages outside of the target images of a mapped cache cannot hold any match
+    if (!isCacheTargetRange(vp, file, vid, PatchTarget::SharedCache, offset, size)) {
+        timer.lap(LatencyPhase::Scan);
+        return;
+    }
+    // Matches per patch for the statistics, split ones are counted by the page completing them
+    uint8_t matches[kMaxMatchPatterns];
+    memset(matches, 0, sizeof(matches));
+    // The file is listed before its sites make HookWorkSites set
+    auto site = [&](size_t index, memory_object_offset_t start, memory_object_offset_t from, memory_object_offset_t to) {
+        matches[index]++;
+        recordPatchSiteFile(vp);
+        recordPatchSite(file, vid, start, *patch_config.dyldPatches[index].desc, from, to);
+    };
+    // Split matches are accounted once the half in the other page is applied, see applyPatchSites
+    auto splitSite = [&](size_t index, memory_object_offset_t start, memory_object_offset_t other) {
+        matches[index]++;
+        recordPatchSiteFile(vp);
+        recordPatchSite(file, vid, start, *patch_config.dyldPatches[index].desc, 0, UINT64_MAX, static_cast<uint8_t>(index + 1), patchSitePage(other));
+    };
+
+    // Keep the original page edges before patching, the neighbour pages may need them
+    size_t edge = boundary_lock ? matcher.boundarySize() : 0;
+    if (edge > size) {
+        edge = size;
+    }
+    uint8_t head[kBoundaryWindow];
+    uint8_t tail[kBoundaryWindow];
+    memcpy(head, bytes, edge);
+    memcpy(tail, bytes + size - edge, edge);
+    uint64_t spent = timer.lap(LatencyPhase::Patch);
+
+    // Pages searched before without any match only exchange their edges
+    uint32_t applied = 0;
+    uint32_t split = 0;  // split matches, only patched in this page so far
+    bool clean = isCleanRange(file, vid, offset, size);
+    if (!clean) {
+        // Single pass over the page for every pending patch set
+        applied = matcher.scanAndPatch(bytes, size, enabled & ~patch_config.dyldSkipMask, nullptr, [&](size_t index, size_t at) {
+            site(index, offset + at, offset, offset + size);
+        });
+        // Long patterns skip most of the page instead
+        for (uint32_t skipped = enabled & patch_config.dyldSkipMask; skipped != 0; skipped &= skipped - 1) {
+            size_t index = __builtin_ctz(skipped);
+            const MatchPattern &pattern = matcher.pattern(index);
+            SkipSearch search(pattern, *patch_config.dyldPatches[index].desc->skip);
+            for (size_t at = search.search(bytes, size); at != SIZE_MAX; at = search.search(bytes, size, at + pattern.size)) {
+                matcher.apply(&bytes[at], index);
+                site(index, offset + at, offset, offset + size);
+                applied |= 1U << index;
             }
         }
-        for (size_t i = 0; i < arrsize(imac_2015_broadwell_models); i++) {
-            if (strncmp(deviceInfo.modelIdentifier, imac_2015_broadwell_models[i], strlen(imac_2015_broadwell_models[i])) == 0) {
-                model_is_iMac_2015_broadwell = true;
-                DBGLOG(MODULE_SHORT, "Detected iMac 2015 Broadwell model");
+        if (applied == 0) {
+            markCleanPages(file, vid, offset, size);
+        }
+    }
+
+    if (edge > 0) {
+        uint8_t previous[kBoundaryWindow];
+        uint8_t next[kBoundaryWindow];
+        size_t previousSize = 0;
+        size_t nextSize = 0;
+        IOSimpleLockLock(boundary_lock);
+        bool hasPrevious = takeBoundaryEdge(vp, vid, offset, false, previous, previousSize);
+        bool hasNext = takeBoundaryEdge(vp, vid, offset + size, true, next, nextSize);
+        storeBoundaryEdge(vp, vid, offset, true, head, edge);
+        storeBoundaryEdge(vp, vid, offset + size, false, tail, edge);
+        IOSimpleLockUnlock(boundary_lock);
+        // Match started at the end of the previous page
+        if (hasPrevious) {
+            matcher.scanBoundary(previous, previousSize, head, edge, enabled, [&](size_t index, size_t at) {
+                matcher.apply(bytes, index, at, matcher.pattern(index).size - at);
+                splitSite(index, offset - at, offset - at);
+                split |= 1U << index;
+            });
+        }
+        // Match continues on the next page
+        if (hasNext) {
+            matcher.scanBoundary(tail, edge, next, nextSize, enabled, [&](size_t index, size_t at) {
+                matcher.apply(bytes + size - at, index, 0, at);
+                splitSite(index, offset + size - at, offset + size);
+                split |= 1U << index;
+            });
+        }
+    }
+    spent += timer.lap(LatencyPhase::Scan);
+
+    // The pass is shared, its time is split evenly between the pending patches
+    uint64_t share = enabled != 0 ? spent / __builtin_popcount(enabled) : 0;
+    uint32_t written = applied | split;
+    for (uint32_t pending = clean && written == 0 ? 0 : enabled; pending != 0; pending &= pending - 1) {
+        size_t index = __builtin_ctz(pending);
+        statsCountPatch(*patch_config.dyldPatches[index].desc, size, matches[index], written & (1U << index), share);
+    }
+
+    while (UNLIKELY(applied != 0)) {
+        size_t index = __builtin_ctz(applied);
+        applied &= applied - 1;
+        recordDyldPatch(index, vp);
+    }
+    timer.lap(LatencyPhase::Patch);
+}
+
+static inline HookClass hookClass(VnodeClass cls) {
+    switch (cls) {
+        case VnodeClass::SharedCache:
+            return HookClass::SharedCache;
+        case VnodeClass::UniversalControl:
+            return HookClass::UniversalControl;
+        case VnodeClass::ControlCenter:
+            return HookClass::ControlCenter;
+        default:
+            return HookClass::Other;
+    }
+}
+
+#pragma mark - Binary patching
+
+// Pages patched before are patched again at the recorded offsets, others only searched within the target sections
+static void patchBinaryPage(vnode_t vp, VnodeClass cls, PatchTarget target, memory_object_offset_t offset, const void *data, size_t size, HookTimer &timer) {
+    auto patch = patch_config.binaryPatches[static_cast<size_t>(target)];
+    if (!patch) {
+        return;
+    }
+    uint32_t vid;
+    uintptr_t file = patchSiteFile(vp, cls, vid);
+    if (applyPatchSites(file, vid, offset, data, size, timer)) {
+        return;
+    }
+    if (!isCacheTargetRange(vp, file, vid, target, offset, size)) {
+        timer.lap(LatencyPhase::Scan);
+        return;
+    }
+    searchAndPatch(vp, cls, offset, data, size, *patch, timer);
+}
+
+#pragma mark - Patched functions
+
+// pre Big Sur
+static boolean_t patched_cs_validate_range(vnode_t vp, memory_object_t pager, memory_object_offset_t offset, const void *data, vm_size_t size, unsigned *result) {
+    boolean_t res = FunctionCast(patched_cs_validate_range, orig_cs_validate)(vp, pager, offset, data, size, result);
+
+    // Steady state once everything is patched
+    if (!res) {
+        return res;
+    }
+    // Same steady state as patched_cs_validate_page
+    uint32_t work = __atomic_load_n(&patch_progress.work, __ATOMIC_RELAXED);
+    if (work == 0 || (work == HookWorkSites && !isPatchSiteFile(vp))) {
+        statsCountHook(HookClass::Bypassed);
+        return res;
+    }
+    HookTimer timer;
+    VnodeClass cls = classifyVnode(vp);
+    timer.lap(LatencyPhase::Classify);
+    statsCountHook(hookClass(cls));
+    if (cls == VnodeClass::SharedCache) {
+        uint32_t vid;
+        uintptr_t file = patchSiteFile(vp, cls, vid);
+        if (applyPatchSites(file, vid, offset, data, size, timer) || dyldPatchingDone()) {
+            return res;
+        }
+        scanDyldPage(vp, offset, data, size, timer);
+    }
+    return res;
+}
+
+// For Big Sur and newer
+static void patched_cs_validate_page(vnode_t vp, memory_object_t pager, memory_object_offset_t page_offset, const void *data, int *validated_p, int *tainted_p, int *nx_p) {
+    FunctionCast(patched_cs_validate_page, orig_cs_validate)(vp, pager, page_offset, data, validated_p, tainted_p, nx_p);
+
+    // Steady state once everything is patched: nothing left, or only re-page sites and not a shared cache file holding any.
+    // Binary patches keep every page classified, as their pages may be validated again.
+    uint32_t work = __atomic_load_n(&patch_progress.work, __ATOMIC_RELAXED);
+    if (work == 0 || (work == HookWorkSites && !isPatchSiteFile(vp))) {
+        statsCountHook(HookClass::Bypassed);
+        return;
+    }
+
+    HookTimer timer;
+    VnodeClass cls = classifyVnode(vp);
+    timer.lap(LatencyPhase::Classify);
+    statsCountHook(hookClass(cls));
+    switch (cls) {
+        // dyld_shared_cache patching
+        case VnodeClass::SharedCache: {
+            // Pages patched before are patched again at the recorded offsets
+            uint32_t vid;
+            uintptr_t file = patchSiteFile(vp, cls, vid);
+            if (applyPatchSites(file, vid, page_offset, data, PAGE_SIZE, timer)) {
+                break;
+            }
+
+            // If we've already patched everything we can, exit early
+            if (dyldPatchingDone()) {
                 return;
             }
-        }
-        for (size_t i = 0; i < arrsize(imac_2015_2017_models); i++) {
-            if (strncmp(deviceInfo.modelIdentifier, imac_2015_2017_models[i], strlen(imac_2015_2017_models[i])) == 0) {
-                model_is_iMac_2015_2017 = true;
-                DBGLOG(MODULE_SHORT, "Detected iMac 2015-2017 model");
+
+            /*
+            Check if too much time has passed since start
+            We know the dyld patching should finish within 5 minutes, matches split between
+            pages are handled by the boundary carry-over, this is only a safety net against
+            patch sets that no longer match the OS (ie. wasted loops)
+            */
+            if (dyldPatchingExpired()) {
                 return;
             }
+
+            // Continuity Camera, NightShift, Sidecar, AirPlay and VMM patches share one pass.
+            // Note: VMM check may be inside the same page as the model check, thus every
+            // pending patch set is matched against the whole page.
+            scanDyldPage(vp, page_offset, data, PAGE_SIZE, timer);
+            break;
+        }
+
+        // Individual binary patching
+        // Universal Control.app patch
+        case VnodeClass::UniversalControl:
+            patchBinaryPage(vp, cls, PatchTarget::UniversalControl, page_offset, data, PAGE_SIZE, timer);
+            break;
+        case VnodeClass::ControlCenter:
+            patchBinaryPage(vp, cls, PatchTarget::ControlCenter, page_offset, data, PAGE_SIZE, timer);
+            break;
+        default:
+            break;
+    }
+}
+
+#pragma mark - Detect Model
+
+static void detectMachineProperties() {
+    // Detect Hypervisor
+    size_t vmm_present_size = sizeof(host_vmm_present);
+    if (sysctlbyname("kern.hv_vmm_present", &host_vmm_present, &vmm_present_size, NULL, 0) == 0) {
+        if (host_vmm_present == 1) {
+            DBGLOG(MODULE_SHORT, "Detected VMM system");
         }
+    }
+
+    // Detect shared cache variant, dyld picks x86_64h on CPUs with the Haswell feature subset
+    size_t cpu_subtype_size = sizeof(host_cpu_subtype);
+    if (sysctlbyname("hw.cpusubtype", &host_cpu_subtype, &cpu_subtype_size, NULL, 0) == 0) {
+        DBGLOG(MODULE_SHORT, "Detected CPU subtype %d", host_cpu_subtype);
     } else {
+        host_cpu_subtype = 0;
+    }
+
+    // Detect model
+    auto deviceInfo = BaseDeviceInfo::get();
+    SYSLOG(MODULE_SHORT, "Host model detected: %s", deviceInfo.modelIdentifier);
+
+    ModelIdentifier model;
+    if (!parseModelIdentifier(deviceInfo.modelIdentifier, model)) {
         // Unsupported model
         DBGLOG(MODULE_SHORT, "Model is non-standard, assuming no SMBIOS patching is required");
         return;
     }
-    DBGLOG(MODULE_SHORT, "Model appears to not require SMBIOS patching, assuming native");
+    const ModelRange *range = lookupModelRange(model);
+    if (!range) {
+        DBGLOG(MODULE_SHORT, "Model appears to not require SMBIOS patching, assuming native");
+        return;
+    }
+    host_model = range->cls;
+    DBGLOG(MODULE_SHORT, "Detected %s model", range->name);
 }
 
 #pragma mark - Detect Supported Patch sets
 
 static void detectSupportedPatchSets() {
-    // Find all supported patch sets
+    // Find all features the OS blacklists and the user did not opt out of
 
     // NightShift
-    if ((getKernelVersion() == KernelVersion::HighSierra && getKernelMinorVersion() >= 2) || getKernelVersion() >= KernelVersion::Mojave) {
-        DBGLOG(MODULE_SHORT, "OS implements Modern NightShift blacklist");
-        os_supports_nightshift_new = true;
-    } else if (getKernelVersion() == KernelVersion::Sierra && getKernelMinorVersion() >= 5) {
-        DBGLOG(MODULE_SHORT, "OS implements Legacy NightShift blacklist");
-        os_supports_nightshift_old = true;
-    }
-    // Sidecar
-    if (getKernelVersion() >= KernelVersion::Catalina) {
-        DBGLOG(MODULE_SHORT, "OS implements Sidecar blacklist");
-        os_supports_sidecar = true;
-    }
-    // AirPlay and Universal Control
-    if (getKernelVersion() >= KernelVersion::Monterey) {
-        DBGLOG(MODULE_SHORT, "OS implements AirPlay to Mac blacklist");
-        os_supports_airplay_to_mac = true;
-        if (getKernelVersion() >= KernelVersion::Ventura) {
-            // Apple added kern.hv_vmm_present checks in Ventura, in addition to their normal model checks...
-            DBGLOG(MODULE_SHORT, "OS implements AirPlay to Mac VMM blacklist");
-            os_supports_airplay_to_mac_vmm_checks = true;
-        }
-        if ((getKernelVersion() == KernelVersion::Monterey && getKernelMinorVersion() >= 4) || getKernelVersion() >= KernelVersion::Ventura) {
-            DBGLOG(MODULE_SHORT, "OS implements Universal Control blacklist");
-            os_supports_universal_control = true;
-        }
-    }
-
-    // Determine if we need to patch the SMBIOS
-    if (!disable_nightshift && (os_supports_nightshift_old || os_supports_nightshift_new)) {
-        if (model_is_iMac_pre_2012 || model_is_MacPro_pre_2013 || model_is_Macmini_pre_2012 || model_is_MacBook_pre_2015 || model_is_MacBookAir_pre_2012 || model_is_MacBookPro_pre_2012) {
-            DBGLOG(MODULE_SHORT, "Model requires NightShift patch");
-            host_needs_nightshift_patch = true;
-        }
-    }
-    if (!disable_sidecar_mac && (os_supports_sidecar || os_supports_airplay_to_mac || os_supports_universal_control)) {
-        // Sidecar (iPad specific)
-        if (allow_sidecar_ipad) {
-            DBGLOG(MODULE_SHORT, "Model requested Sidecar iPad patch");
-        }
-
-        // Sidecar and AirPlay to Mac
-        if (// Ivy Bridge to Broadwell (including MacPro5,1)
-            model_is_iMac_2012 || model_is_iMac_2013 || model_is_iMac_2014 || model_is_iMac_2015_broadwell || \
-            model_is_MacPro_2010_2012 || model_is_MacPro_2013 || model_is_Macmini_2012 || model_is_Macmini_2014 || \
-            model_is_MacBook_2015 || model_is_MacBookAir_2012 || model_is_MacBookAir_2013 || model_is_MacBookAir_2015 || \
-            model_is_MacBookPro_2012 || model_is_MacBookPro_2013 || model_is_MacBookPro_2015
-        ) {
-            DBGLOG(MODULE_SHORT, "Model requires Sidecar patch");
-            host_needs_sidecar_patch = true;
-            if (os_supports_airplay_to_mac) {
-                DBGLOG(MODULE_SHORT, "Model requires AirPlay patch");
-                host_needs_airplay_to_mac_patch = true;
-            }
-        }
-        // AirPlay to Mac extended
-        else if (model_is_MacBookPro_2016 || model_is_MacBookPro_2017 || model_is_iMac_2015_2017 || model_is_Macmini_2018) {
-            DBGLOG(MODULE_SHORT, "Model requires AirPlay extended patch");
-            host_needs_airplay_to_mac_patch = true;
-        }
-        if (host_needs_vmm_patch && os_supports_airplay_to_mac_vmm_checks) {
-            DBGLOG(MODULE_SHORT, "Model requires AirPlay VMM patch");
-            host_needs_airplay_to_mac_vmm_patch = true;
+    if (!disable_nightshift) {
+        host_features |= FeatureNightShift;
+    }
+    if (!disable_sidecar_mac) {
+        // Sidecar
+        if (getKernelVersion() >= KernelVersion::Catalina) {
+            DBGLOG(MODULE_SHORT, "OS implements Sidecar blacklist");
+            host_features |= FeatureSidecar;
         }
-
-        // Universal Control
-        if (
-            // Pre-Skylake models native to Monterey
-            model_is_iMac_2015_broadwell || model_is_MacPro_2013 || model_is_Macmini_2014 || model_is_MacBook_2015 || model_is_MacBookAir_2015 || model_is_MacBookPro_2015
-        ) {
-            DBGLOG(MODULE_SHORT, "Model requires Universal Control patch");
-            host_needs_universal_control_patch = true;
+        // AirPlay and Universal Control
+        if (getKernelVersion() >= KernelVersion::Monterey) {
+            DBGLOG(MODULE_SHORT, "OS implements AirPlay to Mac blacklist");
+            host_features |= FeatureAirPlay | FeatureUniversalControl;
         }
-        else if (force_universal_control) {
-            DBGLOG(MODULE_SHORT, "Model requested Universal Control patch");
-            host_needs_universal_control_patch = true;
+        // Apple added kern.hv_vmm_present checks in Ventura, in addition to their normal model checks...
+        if (host_vmm_present) {
+            host_features |= FeatureAirPlayVmm;
         }
-        
         // Continuity Camera
-        if (getKernelVersion() >= KernelVersion::Ventura && BaseDeviceInfo::get().cpuGeneration < CPUInfo::CpuGeneration::KabyLake) {
-            DBGLOG(MODULE_SHORT, "Model requires Continuity Camera patch");
-            host_needs_continuity_patch = true;
+        if (BaseDeviceInfo::get().cpuGeneration < CPUInfo::CpuGeneration::KabyLake) {
+            host_features |= FeatureContinuity;
         }
     }
-
+    // Sidecar (iPad specific), the pre Big Sur patch always ignored -disable_sidecar_mac
+    if (allow_sidecar_ipad && (!disable_sidecar_mac || getKernelVersion() < KernelVersion::BigSur)) {
+        DBGLOG(MODULE_SHORT, "Model requested Sidecar iPad patch");
+        host_features |= FeatureSidecariPad;
+    }
 }
 
-static void detectNumberOfPatches() {
-    // Detects Number of patches applied in dyld
-    if ((os_supports_nightshift_new || os_supports_nightshift_old) && !disable_nightshift) {
-        if (host_needs_nightshift_patch) {
-            total_allowed_loops++;
-        }
+#pragma mark - Resolve Active Patch Sets
+
+static bool isPatchApplicable(const PatchDescriptor &patch, uint32_t os) {
+    if (os < patch.minOs || os > patch.maxOs || (patch.features & host_features) == 0) {
+        return false;
     }
+    if (patch.models == 0 || (patch.models & host_model) != 0) {
+        return true;
+    }
+    if (force_universal_control && (patch.features & FeatureUniversalControl) != 0) {
+        DBGLOG(MODULE_SHORT, "Model requested %s patch", patch.name);
+        return true;
+    }
+    return false;
+}
 
-    if (os_supports_sidecar) {
-        if (!disable_sidecar_mac) {
-            // Sidecar Models
-            if (host_needs_sidecar_patch) {
-                total_allowed_loops++;
-            }
-            if (os_supports_airplay_to_mac) {
-                // AirPlay to Mac Models
-                if (host_needs_airplay_to_mac_patch) {
-                    total_allowed_loops++;
-                }
-                if (os_supports_universal_control && host_needs_universal_control_patch) {
-                    total_allowed_loops++;
-                }
-                if (os_supports_airplay_to_mac_vmm_checks && host_needs_airplay_to_mac_vmm_patch) {
-                    total_allowed_loops++;
-                }
-            }
+static void resolvePatchSets(PatchConfig &config) {
+    // Only the patches this host needs are kept, the hook then scans each page once
+    uint32_t os = osVersion(getKernelVersion(), getKernelMinorVersion());
+    for (auto &patch : kPatchDescriptors) {
+        if (!isPatchApplicable(patch, os)) {
+            continue;
+        }
+        stats_active_patches |= 1U << patchDescriptorIndex(patch);
+        if (patch.target != PatchTarget::SharedCache) {
+            config.binaryPatches[static_cast<size_t>(patch.target)] = &patch;
+            DBGLOG(MODULE_SHORT, "Model requires %s patch", patch.name);
+            continue;
         }
-        if (allow_sidecar_ipad) {
-            total_allowed_loops++;
+        int index = config.dyldMatcher.add(patch.pattern());
+        if (index < 0) {
+            SYSLOG(MODULE_SHORT, "Failed to register patch set %s", patch.name);
+            continue;
         }
+        // Completion is derived from the features a patch serves on this host,
+        // one-shot patches are no longer looked for after their first match
+        uint32_t quota = patch.oneShot ? 1 : __builtin_popcount(patch.features & host_features);
+        config.dyldPatches[index] = {&patch, quota};
+        config.dyldPatchMask |= 1U << index;
+        if (patch.engine == MatchEngine::Horspool) {
+            config.dyldSkipMask |= 1U << index;
+        }
+        config.allowedLoops += quota;
+        DBGLOG(MODULE_SHORT, "Model requires %s patch (expected matches %u)", patch.name, quota);
+    }
+    DBGLOG(MODULE_SHORT, "Total allowed loops: %u", config.allowedLoops);
+
+    // Pages of the shared cache variant userspace does not map are rejected by name
+    if (host_cpu_subtype == CPU_SUBTYPE_X86_64_H) {
+        config.sharedCacheName = "dyld_shared_cache_x86_64h";
+    } else if (host_cpu_subtype != 0) {
+        config.sharedCacheName = "dyld_shared_cache_x86_64";
     }
-    if (host_needs_continuity_patch) {
-        total_allowed_loops++;
+    if (config.sharedCacheName) {
+        DBGLOG(MODULE_SHORT, "Only patching %s shared caches", config.sharedCacheName);
     }
-    DBGLOG(MODULE_SHORT, "Total allowed loops: %d", total_allowed_loops);
 }
 
 #pragma mark - Boot Arguments
@@ -719,12 +1459,60 @@ static void detectBootArgs() {
 
 static void pluginStart() {
     DBGLOG(MODULE_SHORT, "start");
-    start_time = mach_absolute_time();
+    uint64_t timeout;
+    nanoseconds_to_absolutetime(kDyldPatchingTimeoutNs, &timeout);
+    patch_config.deadline = mach_absolute_time() + timeout;
+    boundary_lock = IOSimpleLockAlloc();
+    if (!boundary_lock) {
+        SYSLOG(MODULE_SHORT, "failed to allocate boundary lock, split matches are disabled");
+    }
+    site_lock = IOSimpleLockAlloc();
+    if (!site_lock) {
+        SYSLOG(MODULE_SHORT, "failed to allocate site lock, re-validated pages are searched again");
+    }
     detectBootArgs();
     detectMachineProperties();
     detectSupportedPatchSets();
-    detectNumberOfPatches();
-    lilu.onPatcherLoadForce([](void *user, KernelPatcher &patcher) {
+    resolvePatchSets(patch_config);
+    patch_progress.pending = patch_config.dyldPatchMask;
+    if (patch_config.dyldPatchMask != 0) {
+        clean_lock = IOSimpleLockAlloc();
+        clean_regions = clean_lock ? Buffer::create<CleanRegion>(kCleanRegionSlots) : nullptr;
+        if (clean_regions) {
+            memset(clean_regions, 0, sizeof(CleanRegion) * kCleanRegionSlots);
+        } else {
+            SYSLOG(MODULE_SHORT, "failed to allocate clean page cache, re-validated pages are searched again");
+        }
+    }
+    uint32_t work = 0;
+    if (patch_config.allowedLoops != 0) {
+        work |= HookWorkDyld;
+    }
+    for (auto patch : patch_config.binaryPatches) {
+        if (patch) {
+            work |= HookWorkBinary;
+        }
+    }
+    if (patch_config.dyldPatchMask != 0 || (work & HookWorkBinary) != 0) {
+        cache_map_lock = IOSimpleLockAlloc();
+        cache_map_call = cache_map_lock ? thread_call_allocate(mapSharedCaches, nullptr) : nullptr;
+        if (!cache_map_call) {
+            SYSLOG(MODULE_SHORT, "failed to allocate target file map call, every page of the patched files is scanned");
+        }
+    }
+    patch_progress.work = work;
+    if (patch_config.dyldPatchMask != 0) {
+        patch_config.targetClasses |= vnodeClassBit(VnodeClass::SharedCache);
+    }
+    if (patch_config.binaryPatches[static_cast<size_t>(PatchTarget::UniversalControl)]) {
+        patch_config.targetClasses |= vnodeClassBit(VnodeClass::UniversalControl);
+    }
+    if (patch_config.binaryPatches[static_cast<size_t>(PatchTarget::ControlCenter)]) {
+        patch_config.targetClasses |= vnodeClassBit(VnodeClass::ControlCenter);
+    }
+    registerStatsSysctl();
+    registerProgressSysctl();
+    lilu.onPatcherLoadForce([](void *, KernelPatcher &patcher) {
         KernelPatcher::RouteRequest csRoute =
             getKernelVersion() >= KernelVersion::BigSur ?
             KernelPatcher::RouteRequest("_cs_validate_page", patched_cs_validate_page, orig_cs_validate) :
@@ -0,0 +1,279 @@
+//
+//  kern_stats.hpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+// Hook and patch counters exported through the kern.featureunlock sysctl node.
+// Counters are kept per CPU and only summed when read, so the hooks never share
+// a cache line with another CPU.
+
+#ifndef kern_stats_hpp
+#define kern_stats_hpp
+
+#include <sys/sysctl.h>
+#include <kern/clock.h>
+#include <kern/cpu_number.h>
+#include "kern_patch_set.hpp"
+
+#pragma mark - Counters
+
+enum class HookClass : uint8_t {
+    SharedCache,
+    UniversalControl,
+    ControlCenter,
+    Other,
+    Bypassed,  // nothing left to patch, returned right after the original
+    Count
+};
+
+struct PatchStats {
+    uint64_t pages;     // pages the patch was looked for in
+    uint64_t bytes;
+    uint64_t matches;   // pattern matches, split matches counted once by the page completing them
+    uint64_t applied;   // pages patched
+    uint64_t time;      // absolute time spent, estimated from sampled invocations and split between patches sharing a pass
+};
+
+static constexpr size_t kStatsCpuSlots = 64;
+static constexpr size_t kPatchDescriptorCount = arrsize(kPatchDescriptors);
+
+// Time added to a validation by the hook, the original function is excluded
+enum class LatencyPhase : uint8_t {
+    Classify,  // vnode classification, vn_getpath on cache misses
+    Scan,      // looking for patches in the page
+    Patch,     // applying and accounting patches, split page fixups
+    Total,
+    Count
+};
+
+// Bucket N counts durations in [2^N, 2^(N+1)) absolute time units, the last one everything above
+static constexpr size_t kLatencyBuckets = 24;
+
+struct alignas(64) CpuStats {
+    uint64_t hooks[static_cast<size_t>(HookClass::Count)];
+    PatchStats patches[kPatchDescriptorCount];
+    uint64_t latency[static_cast<size_t>(LatencyPhase::Count)][kLatencyBuckets];
+    uint32_t sampleTick;
+};
+
+static CpuStats cpu_stats[kStatsCpuSlots];
+
+// Registry indices of the patches resolved for this host
+static uint32_t stats_active_patches;
+
+// Hook invocations timed, 1 in N per CPU, 0 disables timing until enabled through sysctl
+static uint32_t stats_sample_rate = 0;
+
+static inline CpuStats &currentCpuStats() {
+    // Slots are only shared past kStatsCpuSlots CPUs or after a migration, updates stay atomic for that case
+    return cpu_stats[static_cast<size_t>(cpu_number()) & (kStatsCpuSlots - 1)];
+}
+
+static inline size_t patchDescriptorIndex(const PatchDescriptor &patch) {
+    return static_cast<size_t>(&patch - kPatchDescriptors);
+}
+
+static inline void statsAdd(uint64_t &counter, uint64_t value) {
+    __atomic_fetch_add(&counter, value, __ATOMIC_RELAXED);
+}
+
+static inline void statsCountHook(HookClass cls) {
+    statsAdd(currentCpuStats().hooks[static_cast<size_t>(cls)], 1);
+}
+
+static inline void statsCountPatch(const PatchDescriptor &patch, size_t bytes, uint32_t matches, bool applied, uint64_t time) {
+    PatchStats &stats = currentCpuStats().patches[patchDescriptorIndex(patch)];
+    statsAdd(stats.pages, 1);
+    statsAdd(stats.bytes, bytes);
+    if (matches != 0) {
+        statsAdd(stats.matches, matches);
+    }
+    if (applied) {
+        statsAdd(stats.applied, 1);
+    }
+    statsAdd(stats.time, time);
+}
+
+#pragma mark - Latency
+
+static inline void statsRecordLatency(LatencyPhase phase, uint64_t time) {
+    size_t bucket = 63 - __builtin_clzll(time | 1);
+    if (bucket >= kLatencyBuckets) {
+        bucket = kLatencyBuckets - 1;
+    }
+    statsAdd(currentCpuStats().latency[static_cast<size_t>(phase)][bucket], 1);
+}
+
+/*
+Splits the time spent in a hook invocation between phases. Only sampled invocations
+read the clock, the others only bump a per-CPU tick, so that timing does not dominate
+the fast path of irrelevant pages.
+*/
+class HookTimer {
+    uint64_t start {0};
+    uint64_t last {0};
+    uint64_t phases[static_cast<size_t>(LatencyPhase::Count)] {};
+    uint32_t rate {0};
+    uint8_t ran {0};
+
+public:
+    HookTimer() {
+        uint32_t sampleRate = __atomic_load_n(&stats_sample_rate, __ATOMIC_RELAXED);
+        if (sampleRate != 0 && ++currentCpuStats().sampleTick % sampleRate == 0) {
+            rate = sampleRate;
+            start = last = mach_absolute_time();
+        }
+    }
+
+    HookTimer(const HookTimer &) = delete;
+    HookTimer &operator=(const HookTimer &) = delete;
+
+    ~HookTimer() {
+        if (rate == 0) {
+            return;
+        }
+        for (size_t i = 0; i < static_cast<size_t>(LatencyPhase::Total); i++) {
+            if (ran & (1U << i)) {
+                statsRecordLatency(static_cast<LatencyPhase>(i), phases[i]);
+            }
+        }
+        statsRecordLatency(LatencyPhase::Total, last - start);
+    }
+
+    // Charges the time since the previous lap to phase
+    // Returns it scaled by the sample rate as an estimate for cumulative counters, 0 when not sampled
+    uint64_t lap(LatencyPhase phase) {
+        if (rate == 0) {
+            return 0;
+        }
+        uint64_t now = mach_absolute_time();
+        uint64_t elapsed = now - last;
+        last = now;
+        phases[static_cast<size_t>(phase)] += elapsed;
+        ran |= 1U << static_cast<size_t>(phase);
+        return elapsed * rate;
+    }
+};
+
+#pragma mark - Sysctl Interface
+
+static uint64_t statsLoad(const uint64_t &counter) {
+    return __atomic_load_n(&counter, __ATOMIC_RELAXED);
+}
+
+static PatchStats statsSumPatch(size_t index) {
+    PatchStats sum {};
+    for (auto &slot : cpu_stats) {
+        const PatchStats &stats = slot.patches[index];
+        sum.pages += statsLoad(stats.pages);
+        sum.bytes += statsLoad(stats.bytes);
+        sum.matches += statsLoad(stats.matches);
+        sum.applied += statsLoad(stats.applied);
+        sum.time += statsLoad(stats.time);
+    }
+    return sum;
+}
+
+static int sysctlHookCount(struct sysctl_oid *oidp, void *, int arg2, struct sysctl_req *req) {
+    uint64_t value = 0;
+    for (auto &slot : cpu_stats) {
+        value += statsLoad(slot.hooks[arg2]);
+    }
+    return sysctl_handle_quad(oidp, &value, 0, req);
+}
+
+// One line per active patch: name, pages, bytes, matches, applied, ns (estimated from sampled invocations only)
+static int sysctlPatchTable(struct sysctl_oid *, void *, int, struct sysctl_req *req) {
+    char line[192];
+    for (size_t i = 0; i < kPatchDescriptorCount; i++) {
+        if (!(stats_active_patches & (1U << i))) {
+            continue;
+        }
+        PatchStats stats = statsSumPatch(i);
+        uint64_t ns = 0;
+        absolutetime_to_nanoseconds(stats.time, &ns);
+        int len = snprintf(line, sizeof(line), "%s: pages %llu bytes %llu matches %llu applied %llu ns %llu\n", kPatchDescriptors[i].name,
+                           static_cast<unsigned long long>(stats.pages), static_cast<unsigned long long>(stats.bytes),
+                           static_cast<unsigned long long>(stats.matches), static_cast<unsigned long long>(stats.applied),
+                           static_cast<unsigned long long>(ns));
+        if (len <= 0) {
+            continue;
+        }
+        int err = SYSCTL_OUT(req, line, min(static_cast<size_t>(len), sizeof(line) - 1));
+        if (err) {
+            return err;
+        }
+    }
+    return SYSCTL_OUT(req, "", 1);
+}
+
+// One line per phase listing the upper bound in ns and the count of every non-empty bucket
+static int sysctlLatency(struct sysctl_oid *, void *, int, struct sysctl_req *req) {
+    static const char *phaseNames[] {"classify", "scan", "patch", "total"};
+    static_assert(arrsize(phaseNames) == static_cast<size_t>(LatencyPhase::Count), "phase names invalid");
+    char entry[48];
+    for (size_t phase = 0; phase < static_cast<size_t>(LatencyPhase::Count); phase++) {
+        int err = SYSCTL_OUT(req, phaseNames[phase], strlen(phaseNames[phase]));
+        for (size_t bucket = 0; err == 0 && bucket < kLatencyBuckets; bucket++) {
+            uint64_t count = 0;
+            for (auto &slot : cpu_stats) {
+                count += statsLoad(slot.latency[phase][bucket]);
+            }
+            if (count == 0) {
+                continue;
+            }
+            int len;
+            if (bucket + 1 < kLatencyBuckets) {
+                uint64_t bound = 0;
+                absolutetime_to_nanoseconds(1ULL << (bucket + 1), &bound);
+                len = snprintf(entry, sizeof(entry), " <%llu:%llu", static_cast<unsigned long long>(bound), static_cast<unsigned long long>(count));
+            } else {
+                len = snprintf(entry, sizeof(entry), " max:%llu", static_cast<unsigned long long>(count));
+            }
+            if (len > 0) {
+                err = SYSCTL_OUT(req, entry, min(static_cast<size_t>(len), sizeof(entry) - 1));
+            }
+        }
+        if (err == 0) {
+            err = SYSCTL_OUT(req, "\n", 1);
+        }
+        if (err) {
+            return err;
+        }
+    }
+    return SYSCTL_OUT(req, "", 1);
+}
+
+SYSCTL_NODE(_kern, OID_AUTO, featureunlock, CTLFLAG_RD | CTLFLAG_LOCKED, 0, "FeatureUnlock statistics");
+SYSCTL_PROC(_kern_featureunlock, OID_AUTO, hook_shared_cache, CTLTYPE_QUAD | CTLFLAG_RD | CTLFLAG_LOCKED,
+            nullptr, static_cast<int>(HookClass::SharedCache), sysctlHookCount, "Q", "Validated dyld shared cache pages");
+SYSCTL_PROC(_kern_featureunlock, OID_AUTO, hook_universal_control, CTLTYPE_QUAD | CTLFLAG_RD | CTLFLAG_LOCKED,
+            nullptr, static_cast<int>(HookClass::UniversalControl), sysctlHookCount, "Q", "Validated UniversalControl pages");
+SYSCTL_PROC(_kern_featureunlock, OID_AUTO, hook_control_center, CTLTYPE_QUAD | CTLFLAG_RD | CTLFLAG_LOCKED,
+            nullptr, static_cast<int>(HookClass::ControlCenter), sysctlHookCount, "Q", "Validated ControlCenter pages");
+SYSCTL_PROC(_kern_featureunlock, OID_AUTO, hook_other, CTLTYPE_QUAD | CTLFLAG_RD | CTLFLAG_LOCKED,
+            nullptr, static_cast<int>(HookClass::Other), sysctlHookCount, "Q", "Validated pages of other files");
+SYSCTL_PROC(_kern_featureunlock, OID_AUTO, hook_bypassed, CTLTYPE_QUAD | CTLFLAG_RD | CTLFLAG_LOCKED,
+            nullptr, static_cast<int>(HookClass::Bypassed), sysctlHookCount, "Q", "Validated pages once nothing was left to patch");
+SYSCTL_PROC(_kern_featureunlock, OID_AUTO, patches, CTLTYPE_STRING | CTLFLAG_RD | CTLFLAG_LOCKED,
+            nullptr, 0, sysctlPatchTable, "A", "Per patch counters, ns stays 0 unless sample_rate is set");
+SYSCTL_PROC(_kern_featureunlock, OID_AUTO, latency, CTLTYPE_STRING | CTLFLAG_RD | CTLFLAG_LOCKED,
+            nullptr, 0, sysctlLatency, "A", "Hook latency histograms");
+SYSCTL_UINT(_kern_featureunlock, OID_AUTO, sample_rate, CTLFLAG_RW | CTLFLAG_LOCKED,
+            &stats_sample_rate, 0, "Time 1 in N hook invocations for latency and per patch ns, 0 (default) to disable");
+
+static void registerStatsSysctl() {
+    sysctl_register_oid(&sysctl__kern_featureunlock);
+    sysctl_register_oid(&sysctl__kern_featureunlock_hook_shared_cache);
+    sysctl_register_oid(&sysctl__kern_featureunlock_hook_universal_control);
+    sysctl_register_oid(&sysctl__kern_featureunlock_hook_control_center);
+    sysctl_register_oid(&sysctl__kern_featureunlock_hook_other);
+    sysctl_register_oid(&sysctl__kern_featureunlock_hook_bypassed);
+    sysctl_register_oid(&sysctl__kern_featureunlock_patches);
+    sysctl_register_oid(&sysctl__kern_featureunlock_latency);
+    sysctl_register_oid(&sysctl__kern_featureunlock_sample_rate);
+}
+
+#endif /* kern_stats_hpp */
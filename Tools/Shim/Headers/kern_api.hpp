@@ -0,0 +1,27 @@
+//
+//  kern_api.hpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+#ifndef kern_api_hpp
+#define kern_api_hpp
+
+#include <Headers/kern_patcher.hpp>
+
+class LiluAPI {
+public:
+    enum Requirements {
+        AllowNormal = 1,
+    };
+
+    using t_patcherLoaded = void (*)(void *user, KernelPatcher &patcher);
+
+    // Callbacks are invoked by shimLoadPatcher
+    void onPatcherLoadForce(t_patcherLoaded callback, void *user = nullptr);
+};
+
+extern LiluAPI lilu;
+
+#endif /* kern_api_hpp */
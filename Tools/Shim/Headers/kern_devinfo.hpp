@@ -0,0 +1,45 @@
+//
+//  kern_devinfo.hpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+#ifndef kern_devinfo_hpp
+#define kern_devinfo_hpp
+
+#include <Headers/kern_util.hpp>
+
+namespace CPUInfo {
+    enum class CpuGeneration {
+        Unknown,
+        Penryn,
+        Nehalem,
+        Westmere,
+        SandyBridge,
+        IvyBridge,
+        Haswell,
+        Broadwell,
+        Skylake,
+        KabyLake,
+        CoffeeLake,
+        CometLake,
+        CannonLake,
+        IceLake,
+        RocketLake,
+        AlderLake,
+        RaptorLake,
+        MaxGeneration
+    };
+}
+
+class BaseDeviceInfo {
+public:
+    char modelIdentifier[48] {};
+    CPUInfo::CpuGeneration cpuGeneration {CPUInfo::CpuGeneration::Unknown};
+
+    // Filled from the shim host configuration
+    static const BaseDeviceInfo &get();
+};
+
+#endif /* kern_devinfo_hpp */
@@ -0,0 +1,23 @@
+//
+//  kern_file.hpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+// Host replacement of the subset of Lilu kern_file.hpp used by FeatureUnlock,
+// vnodes are read from the host file backing them.
+
+#ifndef kern_file_hpp
+#define kern_file_hpp
+
+#include <Headers/kern_util.hpp>
+#include <sys/types.h>
+
+class FileIO {
+public:
+    static int readFileData(void *buffer, off_t off, size_t size, vnode_t vnode, vfs_context_t ctxt);
+    static size_t readFileSize(vnode_t vnode, vfs_context_t ctxt);
+};
+
+#endif /* kern_file_hpp */
@@ -0,0 +1,34 @@
+//
+//  kern_patcher.hpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+#ifndef kern_patcher_hpp
+#define kern_patcher_hpp
+
+#include <Headers/kern_util.hpp>
+
+class KernelPatcher {
+public:
+    static constexpr size_t KernelID = 0;
+
+    struct RouteRequest {
+        const char *symbol {nullptr};
+        mach_vm_address_t to {0};
+        mach_vm_address_t *org {nullptr};
+
+        template <typename T>
+        RouteRequest(const char *s, T t, mach_vm_address_t &o) : symbol(s), to(reinterpret_cast<mach_vm_address_t>(t)), org(&o) {}
+    };
+
+    // Routes are recorded by the shim, see shimRoute
+    bool routeMultipleLong(size_t id, RouteRequest *requests, size_t num, mach_vm_address_t start = 0, size_t size = 0, bool kernelRoute = true, bool force = false);
+
+    static bool findAndReplace(void *data, size_t dataSize, const void *find, size_t findSize, const void *replace, size_t replaceSize);
+    static bool findAndReplaceWithMask(void *data, size_t dataSize, const void *find, size_t findSize, const void *findMask, size_t findMaskSize,
+                                       const void *replace, size_t replaceSize, const void *replaceMask, size_t replaceMaskSize, size_t count = 0, size_t skip = 0);
+};
+
+#endif /* kern_patcher_hpp */
@@ -0,0 +1,18 @@
+//
+//  kern_user.hpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+#ifndef kern_user_hpp
+#define kern_user_hpp
+
+#include <Headers/kern_patcher.hpp>
+
+class UserPatcher {
+public:
+    static bool matchSharedCachePath(const char *path);
+};
+
+#endif /* kern_user_hpp */
@@ -0,0 +1,120 @@
+//
+//  kern_util.hpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+// Host replacement of the subset of Lilu kern_util.hpp used by FeatureUnlock, so that
+// the kext sources and the patch set registry build unmodified with tools running on
+// Linux or macOS. Functions are implemented by Tools/Shim/kern_shim.cpp.
+
+#ifndef kern_util_hpp
+#define kern_util_hpp
+
+#include <limits.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#pragma mark - Logging
+
+#ifdef DEBUG
+#define DBGLOG(module, str, ...) fprintf(stderr, "%s: " str "\n", module, ##__VA_ARGS__)
+#else
+#define DBGLOG(module, str, ...) do { } while (0)
+#endif
+#define SYSLOG(module, str, ...) fprintf(stderr, "%s: " str "\n", module, ##__VA_ARGS__)
+
+#define LIKELY(x) __builtin_expect(!!(x), 1)
+#define UNLIKELY(x) __builtin_expect(!!(x), 0)
+
+#pragma mark - Kernel Types
+
+typedef uint64_t mach_vm_address_t;
+typedef int boolean_t;
+typedef struct vnode *vnode_t;
+typedef struct mount *mount_t;
+typedef struct vfs_context *vfs_context_t;
+typedef struct memory_object *memory_object_t;
+typedef uint64_t memory_object_offset_t;
+typedef uintptr_t vm_size_t;
+
+#ifndef PAGE_SIZE
+#define PAGE_SIZE 4096
+#endif
+
+extern "C" uint64_t mach_absolute_time(void);
+extern "C" int vn_getpath(vnode_t vp, char *pathbuf, int *len);
+extern "C" uint32_t vnode_vid(vnode_t vp);
+extern "C" mount_t vnode_mount(vnode_t vp);
+extern "C" int vnode_getwithvid(vnode_t vp, uint32_t vid);
+extern "C" int vnode_put(vnode_t vp);
+extern "C" vfs_context_t vfs_context_create(vfs_context_t ctx);
+extern "C" int vfs_context_rele(vfs_context_t ctx);
+
+#pragma mark - Kernel Version
+
+enum KernelVersion {
+    Unsupported   = 0,
+    SnowLeopard   = 10,
+    Lion          = 11,
+    MountainLion  = 12,
+    Mavericks     = 13,
+    Yosemite      = 14,
+    ElCapitan     = 15,
+    Sierra        = 16,
+    HighSierra    = 17,
+    Mojave        = 18,
+    Catalina      = 19,
+    BigSur        = 20,
+    Monterey      = 21,
+    Ventura       = 22,
+    Sonoma        = 23,
+    Sequoia       = 24,
+};
+
+using KernelMinorVersion = int;
+
+KernelVersion getKernelVersion();
+KernelMinorVersion getKernelMinorVersion();
+bool checkKernelArgument(const char *name);
+uint32_t parseModuleVersion(const char *version);
+
+#pragma mark - Helpers
+
+template <typename T, size_t N>
+constexpr size_t arrsize(const T (&)[N]) {
+    return N;
+}
+
+template <typename T>
+static inline T FunctionCast(T, mach_vm_address_t ptr) {
+    return reinterpret_cast<T>(ptr);
+}
+
+namespace Buffer {
+template <typename T>
+static inline T *create(size_t size) {
+    return static_cast<T *>(malloc(sizeof(T) * size));
+}
+
+template <typename T>
+static inline void deleter(T *buffer) {
+    free(buffer);
+}
+}
+
+template <typename T, typename Y>
+static inline T min(T a, Y b) {
+    return a < b ? a : static_cast<T>(b);
+}
+
+template <typename T, typename Y>
+static inline T max(T a, Y b) {
+    return a > b ? a : static_cast<T>(b);
+}
+
+#endif /* kern_util_hpp */
@@ -0,0 +1,38 @@
+//
+//  plugin_start.hpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+#ifndef plugin_start_hpp
+#define plugin_start_hpp
+
+#include <Headers/kern_api.hpp>
+
+#define xStringify(a) Stringify(a)
+#define Stringify(a) #a
+
+#define xConcat(a, b) Concat(a, b)
+#define Concat(a, b) a ## b
+
+#define ADDPR(a) xConcat(xConcat(PRODUCT_NAME, _), a)
+
+struct PluginConfiguration {
+    const char *product;
+    uint32_t version;
+    uint32_t runmode;
+    const char **disableArg;
+    size_t disableArgNum;
+    const char **debugArg;
+    size_t debugArgNum;
+    const char **betaArg;
+    size_t betaArgNum;
+    KernelVersion minKernel;
+    KernelVersion maxKernel;
+    void (*pluginStart)();
+};
+
+extern PluginConfiguration ADDPR(config);
+
+#endif /* plugin_start_hpp */
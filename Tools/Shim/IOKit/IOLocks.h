@@ -0,0 +1,34 @@
+//
+//  IOLocks.h
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+#ifndef IOLocks_h
+#define IOLocks_h
+
+#include <atomic>
+
+struct IOSimpleLock {
+    std::atomic_flag flag = ATOMIC_FLAG_INIT;
+};
+
+static inline IOSimpleLock *IOSimpleLockAlloc() {
+    return new IOSimpleLock;
+}
+
+static inline void IOSimpleLockFree(IOSimpleLock *lock) {
+    delete lock;
+}
+
+static inline void IOSimpleLockLock(IOSimpleLock *lock) {
+    while (lock->flag.test_and_set(std::memory_order_acquire)) {
+    }
+}
+
+static inline void IOSimpleLockUnlock(IOSimpleLock *lock) {
+    lock->flag.clear(std::memory_order_release);
+}
+
+#endif /* IOLocks_h */
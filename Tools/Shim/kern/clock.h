@@ -0,0 +1,17 @@
+//
+//  clock.h
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+#ifndef clock_h
+#define clock_h
+
+#include <stdint.h>
+
+// Absolute time is kept in nanoseconds by the shim
+extern "C" void absolutetime_to_nanoseconds(uint64_t abstime, uint64_t *result);
+extern "C" void nanoseconds_to_absolutetime(uint64_t nanoseconds, uint64_t *result);
+
+#endif /* clock_h */
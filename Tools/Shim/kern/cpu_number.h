@@ -0,0 +1,13 @@
+//
+//  cpu_number.h
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+#ifndef cpu_number_h
+#define cpu_number_h
+
+extern "C" int cpu_number(void);
+
+#endif /* cpu_number_h */
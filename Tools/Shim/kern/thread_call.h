@@ -0,0 +1,22 @@
+//
+//  thread_call.h
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+#ifndef thread_call_h
+#define thread_call_h
+
+#include <stdint.h>
+
+typedef struct thread_call *thread_call_t;
+typedef void *thread_call_param_t;
+typedef void (*thread_call_func_t)(thread_call_param_t param0, thread_call_param_t param1);
+
+// Calls run synchronously within thread_call_enter, keeping replays deterministic
+extern "C" thread_call_t thread_call_allocate(thread_call_func_t func, thread_call_param_t param0);
+extern "C" bool thread_call_enter(thread_call_t call);
+extern "C" bool thread_call_free(thread_call_t call);
+
+#endif /* thread_call_h */
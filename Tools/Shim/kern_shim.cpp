@@ -0,0 +1,432 @@
+//
+//  kern_shim.cpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+// Host implementation of the Lilu and XNU symbols used by FeatureUnlock.
+// Kernel originals of routed functions always validate the page and leave it untouched.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include <Headers/kern_api.hpp>
+#include <Headers/kern_file.hpp>
+#include <Headers/kern_user.hpp>
+#include <sys/sysctl.h>
+#include <kern/clock.h>
+#include <kern/cpu_number.h>
+#include <kern/thread_call.h>
+#include <mach/machine.h>
+#include "kern_shim.hpp"
+
+LiluAPI lilu;
+sysctl_oid_list sysctl__kern_children;
+
+static ShimHost shim_host {"MacBookPro11,4", CPUInfo::CpuGeneration::Haswell, KernelVersion::Ventura, 0, 0, ""};
+
+struct ShimCallback {
+    LiluAPI::t_patcherLoaded callback;
+    void *user;
+};
+
+struct ShimRoute {
+    const char *symbol;
+    mach_vm_address_t to;
+};
+
+static std::vector<ShimCallback> shim_callbacks;
+static std::vector<ShimRoute> shim_routes;
+static std::vector<sysctl_oid *> shim_oids;
+
+ShimHost &shimHost() {
+    return shim_host;
+}
+
+#pragma mark - Kernel Originals
+
+static void shim_cs_validate_page(vnode_t, memory_object_t, memory_object_offset_t, const void *, int *validated_p, int *tainted_p, int *nx_p) {
+    *validated_p = 1;
+    *tainted_p = 0;
+    *nx_p = 0;
+}
+
+static boolean_t shim_cs_validate_range(vnode_t, memory_object_t, memory_object_offset_t, const void *, vm_size_t, unsigned *result) {
+    *result = 0;
+    return true;
+}
+
+static const ShimRoute shim_originals[] {
+    {"_cs_validate_page", reinterpret_cast<mach_vm_address_t>(shim_cs_validate_page)},
+    {"_cs_validate_range", reinterpret_cast<mach_vm_address_t>(shim_cs_validate_range)},
+};
+
+#pragma mark - Lilu
+
+KernelVersion getKernelVersion() {
+    return shim_host.kernel;
+}
+
+KernelMinorVersion getKernelMinorVersion() {
+    return shim_host.kernelMinor;
+}
+
+bool checkKernelArgument(const char *name) {
+    size_t length = strlen(name);
+    for (const char *arg = shim_host.bootArgs; arg && *arg != '\0'; ) {
+        while (*arg == ' ') {
+            arg++;
+        }
+        size_t argLength = strcspn(arg, " ");
+        if (argLength == length && strncmp(arg, name, length) == 0) {
+            return true;
+        }
+        arg += argLength;
+    }
+    return false;
+}
+
+uint32_t parseModuleVersion(const char *version) {
+    uint32_t result = 0;
+    for (; *version != '\0'; version++) {
+        if (*version >= '0' && *version <= '9') {
+            result = result * 10 + static_cast<uint32_t>(*version - '0');
+        }
+    }
+    return result;
+}
+
+const BaseDeviceInfo &BaseDeviceInfo::get() {
+    static BaseDeviceInfo info;
+    snprintf(info.modelIdentifier, sizeof(info.modelIdentifier), "%s", shim_host.model);
+    info.cpuGeneration = shim_host.cpuGeneration;
+    return info;
+}
+
+void LiluAPI::onPatcherLoadForce(t_patcherLoaded callback, void *user) {
+    shim_callbacks.push_back({callback, user});
+}
+
+bool KernelPatcher::routeMultipleLong(size_t, RouteRequest *requests, size_t num, mach_vm_address_t, size_t, bool, bool) {
+    for (size_t i = 0; i < num; i++) {
+        const ShimRoute *original = nullptr;
+        for (auto &route : shim_originals) {
+            if (strcmp(route.symbol, requests[i].symbol) == 0) {
+                original = &route;
+            }
+        }
+        if (!original) {
+            return false;
+        }
+        *requests[i].org = original->to;
+        shim_routes.push_back({original->symbol, requests[i].to});
+    }
+    return true;
+}
+
+// Every non-overlapping occurrence is replaced after skipping the first skip ones, count limits replacements when not 0
+bool KernelPatcher::findAndReplaceWithMask(void *data, size_t dataSize, const void *find, size_t findSize, const void *findMask, size_t findMaskSize,
+                                           const void *replace, size_t replaceSize, const void *replaceMask, size_t replaceMaskSize, size_t count, size_t skip) {
+    if (findSize == 0 || findSize != replaceSize || (findMask && findMaskSize != findSize) || (replaceMask && replaceMaskSize != replaceSize) || dataSize < findSize) {
+        return false;
+    }
+    auto bytes = static_cast<uint8_t *>(data);
+    auto findBytes = static_cast<const uint8_t *>(find);
+    auto findMaskBytes = static_cast<const uint8_t *>(findMask);
+    auto replaceBytes = static_cast<const uint8_t *>(replace);
+    auto replaceMaskBytes = static_cast<const uint8_t *>(replaceMask);
+    size_t replaced = 0;
+    for (size_t i = 0; i + findSize <= dataSize; i++) {
+        bool match = true;
+        for (size_t j = 0; j < findSize && match; j++) {
+            uint8_t mask = findMaskBytes ? findMaskBytes[j] : 0xFF;
+            match = (bytes[i + j] & mask) == (findBytes[j] & mask);
+        }
+        if (!match) {
+            continue;
+        }
+        if (skip > 0) {
+            skip--;
+        } else {
+            for (size_t j = 0; j < replaceSize; j++) {
+                uint8_t mask = replaceMaskBytes ? replaceMaskBytes[j] : 0xFF;
+                bytes[i + j] = (bytes[i + j] & ~mask) | (replaceBytes[j] & mask);
+            }
+            replaced++;
+            if (count > 0 && replaced == count) {
+                break;
+            }
+        }
+        i += findSize - 1;
+    }
+    return replaced > 0;
+}
+
+bool KernelPatcher::findAndReplace(void *data, size_t dataSize, const void *find, size_t findSize, const void *replace, size_t replaceSize) {
+    return findAndReplaceWithMask(data, dataSize, find, findSize, nullptr, 0, replace, replaceSize, nullptr, 0);
+}
+
+const char *shimSharedCacheDirectory() {
+    if (shim_host.kernel >= KernelVersion::Ventura) {
+        return "/System/Volumes/Preboot/Cryptexes/OS/System/Library/dyld/";
+    }
+    if (shim_host.kernel >= KernelVersion::BigSur) {
+        return "/System/Library/dyld/";
+    }
+    return "/private/var/db/dyld/";
+}
+
+mount_t shimMount(const char *path) {
+    static mount mounts[] {
+        {"/System/Volumes/Preboot/Cryptexes/OS/"},
+        {"/System/"},
+        {"/"}
+    };
+    for (auto &mount : mounts) {
+        if (strncmp(path, mount.root, strlen(mount.root)) == 0) {
+            return &mount;
+        }
+    }
+    return &mounts[arrsize(mounts) - 1];
+}
+
+// x86_64 and x86_64h caches and their numbered sub caches
+bool UserPatcher::matchSharedCachePath(const char *path) {
+    const char *directory = shimSharedCacheDirectory();
+    size_t directoryLength = strlen(directory);
+    static const char prefix[] = "dyld_shared_cache_x86_64";
+    if (strncmp(path, directory, directoryLength) != 0 || strncmp(path + directoryLength, prefix, sizeof(prefix) - 1) != 0) {
+        return false;
+    }
+    const char *suffix = path + directoryLength + sizeof(prefix) - 1;
+    if (*suffix == 'h') {
+        suffix++;
+    }
+    if (*suffix == '.') {
+        suffix++;
+        while (*suffix >= '0' && *suffix <= '9') {
+            suffix++;
+        }
+    }
+    return *suffix == '\0';
+}
+
+#pragma mark - XNU
+
+extern "C" uint64_t mach_absolute_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+extern "C" void absolutetime_to_nanoseconds(uint64_t abstime, uint64_t *result) {
+    *result = abstime;
+}
+
+extern "C" void nanoseconds_to_absolutetime(uint64_t nanoseconds, uint64_t *result) {
+    *result = nanoseconds;
+}
+
+extern "C" int cpu_number(void) {
+#ifdef __linux__
+    int cpu = sched_getcpu();
+    return cpu < 0 ? 0 : cpu;
+#else
+    return 0;
+#endif
+}
+
+extern "C" int vn_getpath(vnode_t vp, char *pathbuf, int *len) {
+    size_t length = strlen(vp->path);
+    if (length + 1 > static_cast<size_t>(*len)) {
+        return ENOSPC;
+    }
+    memcpy(pathbuf, vp->path, length + 1);
+    *len = static_cast<int>(length + 1);
+    return 0;
+}
+
+extern "C" uint32_t vnode_vid(vnode_t vp) {
+    return vp->vid;
+}
+
+extern "C" mount_t vnode_mount(vnode_t vp) {
+    return vp->mount;
+}
+
+extern "C" int vnode_getwithvid(vnode_t vp, uint32_t vid) {
+    return vp->vid == vid ? 0 : ENOENT;
+}
+
+extern "C" int vnode_put(vnode_t) {
+    return 0;
+}
+
+struct vfs_context {
+};
+
+extern "C" vfs_context_t vfs_context_create(vfs_context_t) {
+    static vfs_context context;
+    return &context;
+}
+
+extern "C" int vfs_context_rele(vfs_context_t) {
+    return 0;
+}
+
+struct thread_call {
+    thread_call_func_t func;
+    thread_call_param_t param0;
+};
+
+extern "C" thread_call_t thread_call_allocate(thread_call_func_t func, thread_call_param_t param0) {
+    return new thread_call {func, param0};
+}
+
+extern "C" bool thread_call_enter(thread_call_t call) {
+    call->func(call->param0, nullptr);
+    return false;
+}
+
+extern "C" bool thread_call_free(thread_call_t call) {
+    delete call;
+    return true;
+}
+
+#pragma mark - FileIO
+
+int FileIO::readFileData(void *buffer, off_t off, size_t size, vnode_t vnode, vfs_context_t) {
+    int fd = vnode->file ? open(vnode->file, O_RDONLY) : -1;
+    if (fd < 0) {
+        return EIO;
+    }
+    ssize_t length = pread(fd, buffer, size, off);
+    close(fd);
+    return length == static_cast<ssize_t>(size) ? 0 : EIO;
+}
+
+size_t FileIO::readFileSize(vnode_t vnode, vfs_context_t) {
+    struct stat st;
+    return vnode->file && stat(vnode->file, &st) == 0 ? static_cast<size_t>(st.st_size) : 0;
+}
+
+#pragma mark - Sysctl
+
+int sysctl_shim_out(sysctl_req *req, const void *data, size_t size) {
+    if (req->oldptr) {
+        if (req->oldidx + size > req->oldlen) {
+            return ENOMEM;
+        }
+        memcpy(static_cast<uint8_t *>(req->oldptr) + req->oldidx, data, size);
+    }
+    req->oldidx += size;
+    return 0;
+}
+
+int sysctl_shim_in(sysctl_req *req, void *data, size_t size) {
+    if (!req->newptr || req->newidx + size > req->newlen) {
+        return EINVAL;
+    }
+    memcpy(data, static_cast<const uint8_t *>(req->newptr) + req->newidx, size);
+    req->newidx += size;
+    return 0;
+}
+
+extern "C" int sysctl_handle_int(sysctl_oid *, void *arg1, int arg2, sysctl_req *req) {
+    int value = arg1 ? *static_cast<int *>(arg1) : arg2;
+    int err = SYSCTL_OUT(req, &value, sizeof(value));
+    if (err == 0 && req->newptr && arg1) {
+        err = SYSCTL_IN(req, arg1, sizeof(int));
+    }
+    return err;
+}
+
+extern "C" int sysctl_handle_quad(sysctl_oid *, void *arg1, int, sysctl_req *req) {
+    return SYSCTL_OUT(req, arg1, sizeof(uint64_t));
+}
+
+extern "C" void sysctl_register_oid(sysctl_oid *oidp) {
+    shim_oids.push_back(oidp);
+}
+
+// Only kern.hv_vmm_present and hw.cpusubtype are provided, Haswell and newer run x86_64h
+extern "C" int sysctlbyname(const char *name, void *oldp, size_t *oldlenp, void *, size_t) {
+    if (!oldp || !oldlenp || *oldlenp < sizeof(int)) {
+        return ENOENT;
+    }
+    if (strcmp(name, "kern.hv_vmm_present") == 0) {
+        *static_cast<int *>(oldp) = shim_host.vmmPresent;
+    } else if (strcmp(name, "hw.cpusubtype") == 0) {
+        *static_cast<int *>(oldp) = shim_host.cpuGeneration >= CPUInfo::CpuGeneration::Haswell ? CPU_SUBTYPE_X86_64_H : CPU_SUBTYPE_X86_64_ALL;
+    } else {
+        return ENOENT;
+    }
+    *oldlenp = sizeof(int);
+    return 0;
+}
+
+static std::string shimSysctlName(const sysctl_oid *oid) {
+    if (oid->oid_parent == &sysctl__kern_children) {
+        return std::string("kern.") + oid->oid_name;
+    }
+    for (auto parent : shim_oids) {
+        if (parent->oid_arg1 == oid->oid_parent) {
+            return shimSysctlName(parent) + "." + oid->oid_name;
+        }
+    }
+    return oid->oid_name;
+}
+
+bool shimReadSysctl(const char *name, void *buffer, size_t &size) {
+    for (auto oid : shim_oids) {
+        if ((oid->oid_kind & 0xF) == CTLTYPE_NODE || shimSysctlName(oid) != name) {
+            continue;
+        }
+        sysctl_req req {buffer, size, 0, nullptr, 0, 0};
+        if (oid->oid_handler(oid, oid->oid_arg1, oid->oid_arg2, &req) != 0) {
+            return false;
+        }
+        size = req.oldidx;
+        return true;
+    }
+    return false;
+}
+
+bool shimWriteSysctl(const char *name, const void *buffer, size_t size) {
+    for (auto oid : shim_oids) {
+        if ((oid->oid_kind & 0xF) == CTLTYPE_NODE || (oid->oid_kind & CTLFLAG_WR) == 0 || shimSysctlName(oid) != name) {
+            continue;
+        }
+        sysctl_req req {nullptr, 0, 0, buffer, size, 0};
+        return oid->oid_handler(oid, oid->oid_arg1, oid->oid_arg2, &req) == 0;
+    }
+    return false;
+}
+
+#pragma mark - Patcher
+
+void shimLoadPatcher() {
+    KernelPatcher patcher;
+    for (auto &callback : shim_callbacks) {
+        callback.callback(callback.user, patcher);
+    }
+}
+
+mach_vm_address_t shimRoute(const char *symbol) {
+    for (auto &route : shim_routes) {
+        if (strcmp(route.symbol, symbol) == 0) {
+            return route.to;
+        }
+    }
+    return 0;
+}
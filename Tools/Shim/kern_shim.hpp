@@ -0,0 +1,56 @@
+//
+//  kern_shim.hpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+// Control interface of the host shim, used by tools driving the unmodified kext sources.
+// The host configuration must be filled before calling pluginStart.
+
+#ifndef kern_shim_hpp
+#define kern_shim_hpp
+
+#include <Headers/kern_devinfo.hpp>
+
+struct mount {
+    const char *root;
+};
+
+struct vnode {
+    const char *path;
+    uint32_t vid;
+    mount_t mount;
+    const char *file;  // host file read through FileIO, nullptr when it cannot be read
+};
+
+struct ShimHost {
+    char model[48];
+    CPUInfo::CpuGeneration cpuGeneration;
+    KernelVersion kernel;
+    KernelMinorVersion kernelMinor;
+    int vmmPresent;         // kern.hv_vmm_present
+    const char *bootArgs;   // space separated
+};
+
+ShimHost &shimHost();
+
+// Directory holding the dyld shared cache on the configured OS
+const char *shimSharedCacheDirectory();
+
+// Volume a guest path lives on: the Preboot cryptex, the sealed system volume or the Data volume
+mount_t shimMount(const char *path);
+
+// Invokes the callbacks registered with onPatcherLoadForce, routes are resolved against the shim originals
+void shimLoadPatcher();
+
+// Address of the function routed over a kernel symbol, 0 when not routed
+mach_vm_address_t shimRoute(const char *symbol);
+
+// Reads a registered sysctl by full name, size is updated with the bytes written
+bool shimReadSysctl(const char *name, void *buffer, size_t &size);
+
+// Writes a registered writable sysctl by full name
+bool shimWriteSysctl(const char *name, const void *buffer, size_t size);
+
+#endif /* kern_shim_hpp */
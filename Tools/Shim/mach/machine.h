@@ -0,0 +1,16 @@
+//
+//  machine.h
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+#ifndef machine_h
+#define machine_h
+
+typedef int cpu_subtype_t;
+
+#define CPU_SUBTYPE_X86_64_ALL ((cpu_subtype_t) 3)
+#define CPU_SUBTYPE_X86_64_H   ((cpu_subtype_t) 8)  // Haswell feature subset
+
+#endif /* machine_h */
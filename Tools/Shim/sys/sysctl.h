@@ -0,0 +1,82 @@
+//
+//  sysctl.h
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+// Kernel sysctl interface subset, registered nodes can be read back with shimReadSysctl.
+
+#ifndef sysctl_h
+#define sysctl_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct sysctl_oid;
+
+struct sysctl_req {
+    void *oldptr;
+    size_t oldlen;
+    size_t oldidx;
+    const void *newptr;
+    size_t newlen;
+    size_t newidx;
+};
+
+struct sysctl_oid_list {
+    sysctl_oid *first;
+};
+
+struct sysctl_oid {
+    sysctl_oid_list *oid_parent;
+    sysctl_oid *oid_link;
+    int oid_number;
+    unsigned oid_kind;
+    void *oid_arg1;
+    int oid_arg2;
+    const char *oid_name;
+    int (*oid_handler)(sysctl_oid *oidp, void *arg1, int arg2, sysctl_req *req);
+    const char *oid_fmt;
+    const char *oid_descr;
+};
+
+#define OID_AUTO        (-1)
+
+#define CTLTYPE_NODE    1
+#define CTLTYPE_INT     2
+#define CTLTYPE_STRING  3
+#define CTLTYPE_QUAD    4
+#define CTLTYPE_OPAQUE  5
+
+#define CTLFLAG_RD      0x80000000U
+#define CTLFLAG_WR      0x40000000U
+#define CTLFLAG_RW      (CTLFLAG_RD | CTLFLAG_WR)
+#define CTLFLAG_LOCKED  0x00800000U
+
+int sysctl_shim_out(sysctl_req *req, const void *data, size_t size);
+int sysctl_shim_in(sysctl_req *req, void *data, size_t size);
+
+#define SYSCTL_OUT(r, p, l) sysctl_shim_out((r), (p), (l))
+#define SYSCTL_IN(r, p, l) sysctl_shim_in((r), (p), (l))
+
+extern "C" int sysctlbyname(const char *name, void *oldp, size_t *oldlenp, void *newp, size_t newlen);
+extern "C" int sysctl_handle_int(sysctl_oid *oidp, void *arg1, int arg2, sysctl_req *req);
+extern "C" int sysctl_handle_quad(sysctl_oid *oidp, void *arg1, int arg2, sysctl_req *req);
+extern "C" void sysctl_register_oid(sysctl_oid *oidp);
+
+extern sysctl_oid_list sysctl__kern_children;
+
+#define SYSCTL_NODE(parent, nbr, name, access, handler, descr) \
+    sysctl_oid_list sysctl_##parent##_##name##_children; \
+    sysctl_oid sysctl_##parent##_##name = {&sysctl_##parent##_children, nullptr, nbr, CTLTYPE_NODE | (access), \
+        &sysctl_##parent##_##name##_children, 0, #name, handler, "N", descr}
+
+#define SYSCTL_PROC(parent, nbr, name, access, ptr, arg, handler, fmt, descr) \
+    sysctl_oid sysctl_##parent##_##name = {&sysctl_##parent##_children, nullptr, nbr, access, ptr, arg, #name, handler, fmt, descr}
+
+#define SYSCTL_UINT(parent, nbr, name, access, ptr, val, descr) \
+    sysctl_oid sysctl_##parent##_##name = {&sysctl_##parent##_children, nullptr, nbr, CTLTYPE_INT | (access), ptr, val, #name, \
+        sysctl_handle_int, "IU", descr}
+
+#endif /* sysctl_h */
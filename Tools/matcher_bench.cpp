@@ -0,0 +1,722 @@
+//
+//  matcher_bench.cpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+// Benchmark of page matching engines against every needle of the patch set registry.
+// Each engine counts the non-overlapping matches of a needle in a page corpus without
+// modifying it, so that all engines see the same pages. Results are written as JSON.
+//
+// Build from the repository root:
+//   c++ -std=gnu++14 -O2 -ITools/Shim Tools/matcher_bench.cpp -o matcher_bench
+//
+// Usage:
+//   matcher_bench [-p pages] [-r repeats] [-f file] [-s] > results.json
+//
+// Corpora are synthetic cstring, code, zero and hit pages (cstring pages holding the
+// needle once), -f adds the pages of a real file, e.g. a dyld shared cache.
+// Masked needles additionally get their anchored candidates verified byte by byte, as
+// findAndReplaceWithMask does, and a word at a time, as the kext matcher does.
+// The anchor prefilter and the skip search are also compared per needle over reject-only
+// (cstring, code and zero) and hit pages, next to the engine selectMatchEngine picks.
+// With -s the shared cache patch sets of every macOS version are also searched the way
+// Lilu's findAndReplace does, one full compare pass per patch, against the single pass
+// of the kext matcher over the same pages.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "../FeatureUnlock/kern_patch_set.hpp"
+
+static constexpr size_t kBenchPageSize = 4096;
+
+struct Needle {
+    const char *name;
+    const uint8_t *find;
+    const uint8_t *mask;    // nullptr for exact needles
+    size_t size;
+    MatchAnchor anchor;
+};
+
+struct Corpus {
+    std::string name;
+    std::vector<uint8_t> pages;
+    size_t count;
+};
+
+static inline bool verifyNeedle(const uint8_t *data, const Needle &needle) {
+    if (!needle.mask) {
+        return memcmp(data, needle.find, needle.size) == 0;
+    }
+    for (size_t i = 0; i < needle.size; i++) {
+        if ((data[i] & needle.mask[i]) != (needle.find[i] & needle.mask[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#pragma mark - Engines
+
+// Every engine is prepared once per needle, then counts the matches in one page
+class Engine {
+public:
+    virtual ~Engine() {}
+    virtual const char *name() const = 0;
+    virtual void prepare(const Needle &needle) = 0;
+    virtual size_t count(const uint8_t *data, size_t size) const = 0;
+};
+
+// Full compare at every position
+class NaiveEngine : public Engine {
+    Needle needle {};
+
+public:
+    const char *name() const override { return "naive"; }
+    void prepare(const Needle &n) override { needle = n; }
+    size_t count(const uint8_t *data, size_t size) const override {
+        size_t found = 0;
+        for (size_t i = 0; i + needle.size <= size; i++) {
+            if (verifyNeedle(&data[i], needle)) {
+                found++;
+                i += needle.size - 1;
+            }
+        }
+        return found;
+    }
+};
+
+// Boyer-Moore-Horspool, masked bytes act as wildcards limiting the shifts
+class HorspoolEngine : public Engine {
+    Needle needle {};
+    size_t shift[256];
+
+public:
+    const char *name() const override { return "bmh"; }
+    void prepare(const Needle &n) override {
+        needle = n;
+        size_t last = 0;
+        for (size_t i = 0; i + 1 < needle.size; i++) {
+            if (needle.mask && needle.mask[i] != 0xFF) {
+                last = i + 1;
+            }
+        }
+        std::fill(std::begin(shift), std::end(shift), needle.size - last);
+        for (size_t i = last; i + 1 < needle.size; i++) {
+            shift[needle.find[i]] = needle.size - 1 - i;
+        }
+    }
+    size_t count(const uint8_t *data, size_t size) const override {
+        size_t found = 0;
+        size_t i = 0;
+        while (i + needle.size <= size) {
+            if (verifyNeedle(&data[i], needle)) {
+                found++;
+                i += needle.size;
+            } else {
+                i += shift[data[i + needle.size - 1]];
+            }
+        }
+        return found;
+    }
+};
+
+// memchr for the rarest byte, then the second anchor byte and a full compare
+class MemchrEngine : public Engine {
+    Needle needle {};
+
+public:
+    const char *name() const override { return "anchor-memchr"; }
+    void prepare(const Needle &n) override { needle = n; }
+    size_t count(const uint8_t *data, size_t size) const override {
+        size_t found = 0;
+        if (size < needle.size) {
+            return found;
+        }
+        uint8_t first = needle.find[needle.anchor.first];
+        uint8_t second = needle.find[needle.anchor.second];
+        const uint8_t *start = data + needle.anchor.first;
+        const uint8_t *end = data + size - needle.size + needle.anchor.first + 1;
+        while (start < end) {
+            auto hit = static_cast<const uint8_t *>(memchr(start, first, end - start));
+            if (!hit) {
+                break;
+            }
+            const uint8_t *candidate = hit - needle.anchor.first;
+            if (candidate[needle.anchor.second] == second && verifyNeedle(candidate, needle)) {
+                found++;
+                start = hit + needle.size;
+            } else {
+                start = hit + 1;
+            }
+        }
+        return found;
+    }
+};
+
+// The kext matcher, SWAR anchor prefilter on general purpose registers
+class SwarEngine : public Engine {
+    MultiPatternMatcher matcher;
+
+public:
+    const char *name() const override { return "anchor-swar"; }
+    void prepare(const Needle &n) override {
+        matcher = MultiPatternMatcher();
+        matcher.add({n.find, n.mask, n.find, nullptr, n.size, n.anchor, {0, 0}});
+    }
+    size_t count(const uint8_t *data, size_t size) const override {
+        size_t found = 0;
+        matcher.scan(data, size, 1, [&](size_t, size_t) { found++; });
+        return found;
+    }
+};
+
+// The kext skip search, the probe byte is chosen by expected skip rather than the last byte
+class SkipEngine : public Engine {
+    MatchPattern pattern {};
+    SkipTable table {};
+
+public:
+    const char *name() const override { return "skip"; }
+    void prepare(const Needle &n) override {
+        pattern = {n.find, n.mask, n.find, nullptr, n.size, n.anchor, {}};
+        // Same table the kext builds at compile time for long patterns
+        table = buildSkipTable(n.find, n.mask, n.size);
+    }
+    size_t count(const uint8_t *data, size_t dataSize) const override {
+        SkipSearch search(pattern, table);
+        size_t found = 0;
+        for (size_t i = search.search(data, dataSize); i != SIZE_MAX; i = search.search(data, dataSize, i + pattern.size)) {
+            found++;
+        }
+        return found;
+    }
+};
+
+#ifdef __SSE2__
+// Both anchor bytes compared 16 positions at a time, host only as the kernel may not use vector registers
+class SimdEngine : public Engine {
+    Needle needle {};
+
+public:
+    const char *name() const override { return "simd-sse2"; }
+    void prepare(const Needle &n) override { needle = n; }
+    size_t count(const uint8_t *data, size_t size) const override {
+        size_t found = 0;
+        if (size < needle.size) {
+            return found;
+        }
+        size_t last = size - needle.size;
+        __m128i first = _mm_set1_epi8(static_cast<char>(needle.find[needle.anchor.first]));
+        __m128i second = _mm_set1_epi8(static_cast<char>(needle.find[needle.anchor.second]));
+        size_t next = 0;
+        size_t i = 0;
+        for (; i + 16 <= last + 1; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&data[i + needle.anchor.first]));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&data[i + needle.anchor.second]));
+            unsigned bits = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, second))));
+            while (bits != 0) {
+                size_t position = i + __builtin_ctz(bits);
+                bits &= bits - 1;
+                if (position >= next && verifyNeedle(&data[position], needle)) {
+                    found++;
+                    next = position + needle.size;
+                }
+            }
+        }
+        for (; i <= last; i++) {
+            if (i >= next && verifyNeedle(&data[i], needle)) {
+                found++;
+                next = i + needle.size;
+            }
+        }
+        return found;
+    }
+};
+#endif
+
+// Deterministic automaton over the longest exact run of the needle, masked needles are verified afterwards
+class AutomatonEngine : public Engine {
+    Needle needle {};
+    size_t keyStart {0};
+    size_t keySize {0};
+    std::vector<uint16_t> delta;   // (keySize + 1) states of 256 transitions
+
+public:
+    const char *name() const override { return "automaton"; }
+    void prepare(const Needle &n) override {
+        needle = n;
+        keyStart = 0;
+        keySize = needle.size;
+        if (needle.mask) {
+            keySize = 0;
+            for (size_t i = 0; i < needle.size; ) {
+                size_t j = i;
+                while (j < needle.size && needle.mask[j] == 0xFF) {
+                    j++;
+                }
+                if (j - i > keySize) {
+                    keyStart = i;
+                    keySize = j - i;
+                }
+                i = j + 1;
+            }
+        }
+        const uint8_t *key = needle.find + keyStart;
+        delta.assign((keySize + 1) * 256, 0);
+        // Classic KMP automaton construction, x tracks the fallback state
+        delta[key[0]] = 1;
+        size_t x = 0;
+        for (size_t state = 1; state <= keySize; state++) {
+            for (size_t b = 0; b < 256; b++) {
+                delta[state * 256 + b] = delta[x * 256 + b];
+            }
+            if (state < keySize) {
+                delta[state * 256 + key[state]] = static_cast<uint16_t>(state + 1);
+                x = delta[x * 256 + key[state]];
+            }
+        }
+    }
+    size_t count(const uint8_t *data, size_t size) const override {
+        size_t found = 0;
+        size_t state = 0;
+        size_t next = 0;
+        for (size_t i = 0; i < size; i++) {
+            state = delta[state * 256 + data[i]];
+            if (state != keySize) {
+                continue;
+            }
+            size_t keyEnd = i + 1;
+            if (keyEnd < keySize + keyStart) {
+                continue;
+            }
+            size_t position = keyEnd - keySize - keyStart;
+            if (position >= next && position + needle.size <= size && verifyNeedle(&data[position], needle)) {
+                found++;
+                next = position + needle.size;
+            }
+        }
+        return found;
+    }
+};
+
+#pragma mark - Corpora
+
+static const char *kCstringWords[] {
+    "iMac", "iPad", "MacBookPro", "MacBookAir", "Macmini", "MacPro", "_objc_msgSend", "initWithFrame:",
+    "setValue:forKey:", "kern.", "com.apple.", "NSString", "CFBundleIdentifier", "%s: %d", "sidecar", "airplay",
+};
+
+static void fillCstringPage(uint8_t *page, std::mt19937 &rng) {
+    size_t i = 0;
+    while (i < kBenchPageSize) {
+        const char *word = kCstringWords[rng() % arrsize(kCstringWords)];
+        size_t length = strlen(word);
+        for (size_t k = 0; k < length && i < kBenchPageSize; k++) {
+            page[i++] = static_cast<uint8_t>(word[k]);
+        }
+        // Model identifiers are followed by versions, the rest by random suffixes
+        if (i < kBenchPageSize && rng() % 2 == 0) {
+            page[i++] = static_cast<uint8_t>('0' + rng() % 10);
+            if (i < kBenchPageSize) {
+                page[i++] = ',';
+            }
+        }
+        if (i < kBenchPageSize) {
+            page[i++] = 0;
+        }
+    }
+}
+
+static void fillCodePage(uint8_t *page, std::mt19937 &rng) {
+    // Byte frequencies roughly following x86-64 code
+    static const uint8_t common[] {0x48, 0x89, 0x8B, 0x4C, 0xE8, 0x24, 0x01, 0x0F, 0x00, 0x00, 0x00, 0xFF, 0x45, 0x85, 0xC0, 0x74};
+    for (size_t i = 0; i < kBenchPageSize; i++) {
+        page[i] = rng() % 3 != 0 ? common[rng() % arrsize(common)] : static_cast<uint8_t>(rng());
+    }
+}
+
+static Corpus makeCorpus(const char *name, size_t count, void (*fill)(uint8_t *, std::mt19937 &), uint32_t seed) {
+    Corpus corpus {name, std::vector<uint8_t>(count * kBenchPageSize), count};
+    std::mt19937 rng(seed);
+    for (size_t i = 0; fill && i < count; i++) {
+        fill(&corpus.pages[i * kBenchPageSize], rng);
+    }
+    return corpus;
+}
+
+// cstring pages each holding one of the needles once at a random position, in turn
+static Corpus makeHitCorpus(const Needle *needles, size_t needleCount, size_t count, uint32_t seed) {
+    Corpus corpus = makeCorpus("hit", count, fillCstringPage, seed);
+    std::mt19937 rng(seed);
+    for (size_t i = 0; i < count; i++) {
+        const Needle &needle = needles[i % needleCount];
+        uint8_t *page = &corpus.pages[i * kBenchPageSize];
+        size_t offset = rng() % (kBenchPageSize - needle.size + 1);
+        for (size_t k = 0; k < needle.size; k++) {
+            uint8_t mask = needle.mask ? needle.mask[k] : 0xFF;
+            page[offset + k] = (page[offset + k] & ~mask) | (needle.find[k] & mask);
+        }
+    }
+    return corpus;
+}
+
+static Corpus makeHitCorpus(const Needle &needle, size_t count, uint32_t seed) {
+    return makeHitCorpus(&needle, 1, count, seed);
+}
+
+static bool loadFileCorpus(const char *path, size_t limit, Corpus &corpus) {
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        fprintf(stderr, "%s: cannot open file\n", path);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+    size_t count = std::min(static_cast<size_t>(st.st_size) / kBenchPageSize, limit);
+    corpus = {"file", std::vector<uint8_t>(count * kBenchPageSize), count};
+    bool success = pread(fd, corpus.pages.data(), corpus.pages.size(), 0) == static_cast<ssize_t>(corpus.pages.size());
+    close(fd);
+    return success;
+}
+
+#pragma mark - Measurement
+
+struct Measurement {
+    double nsPerPage;
+    size_t matches;
+};
+
+template <typename F>
+static Measurement measurePages(const Corpus &corpus, size_t repeats, F &&count) {
+    Measurement best {1e300, 0};
+    for (size_t r = 0; r < repeats; r++) {
+        size_t matches = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < corpus.count; i++) {
+            matches += count(&corpus.pages[i * kBenchPageSize], kBenchPageSize);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / std::max<size_t>(corpus.count, 1);
+        if (ns < best.nsPerPage) {
+            best = {ns, matches};
+        }
+    }
+    return best;
+}
+
+static Measurement measure(const Engine &engine, const Corpus &corpus, size_t repeats) {
+    return measurePages(corpus, repeats, [&](const uint8_t *data, size_t size) {
+        return engine.count(data, size);
+    });
+}
+
+// Candidates are the needle with random masked bytes, every second one differing in its last unmasked byte
+static constexpr size_t kVerifyCandidates = 4096;
+
+static std::vector<uint8_t> makeCandidates(const Needle &needle, uint32_t seed) {
+    std::vector<uint8_t> candidates(kVerifyCandidates * needle.size);
+    std::mt19937 rng(seed);
+    size_t last = needle.size - 1;
+    while (last > 0 && needle.mask[last] != 0xFF) {
+        last--;
+    }
+    for (size_t i = 0; i < kVerifyCandidates; i++) {
+        uint8_t *candidate = &candidates[i * needle.size];
+        for (size_t k = 0; k < needle.size; k++) {
+            candidate[k] = (static_cast<uint8_t>(rng()) & ~needle.mask[k]) | (needle.find[k] & needle.mask[k]);
+        }
+        if (i % 2 != 0) {
+            candidate[last] ^= 0x01;
+        }
+    }
+    return candidates;
+}
+
+template <typename F>
+static Measurement measureVerify(const std::vector<uint8_t> &candidates, size_t size, size_t repeats, F &&verify) {
+    Measurement best {1e300, 0};
+    for (size_t r = 0; r < repeats; r++) {
+        size_t matches = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kVerifyCandidates; i++) {
+            matches += verify(&candidates[i * size]);
+            // Keeps the compiler from folding the pure verifications out of the timed loop
+            asm volatile("" : "+r"(matches));
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / kVerifyCandidates;
+        if (ns < best.nsPerPage) {
+            best = {ns, matches};
+        }
+    }
+    return best;
+}
+
+#pragma mark - Engine selection
+
+// Reject page timings this close are within run to run noise, hit pages decide then
+static constexpr double kSelectionTolerance = 0.1;
+
+// Anchor prefilter and skip search timings of a needle, reject pages averaged over the synthetic corpora
+struct Selection {
+    double anchorReject;
+    double anchorHit;
+    double skipReject;
+    double skipHit;
+};
+
+static void printSelection(const Selection *selections) {
+    size_t anchorMax = 0;
+    size_t skipMin = SIZE_MAX;
+    size_t mismatches = 0;
+    printf("\n  ],\n  \"engine_selection\": [\n");
+    for (size_t n = 0; n < arrsize(kPatchDescriptors); n++) {
+        const PatchDescriptor &patch = kPatchDescriptors[n];
+        const Selection &selection = selections[n];
+        SkipTable table = buildSkipTable(patch.find, patch.findMask, patch.size);
+        size_t skip = expectedSkip(table);
+        bool zeroPages = table.probe + table.zeroRun <= patch.size || table.shift[0] >= kHorspoolMinSkip;
+        // Reject pages are the vast majority, hit pages only break ties
+        double rejectGap = selection.anchorReject - selection.skipReject;
+        bool tie = std::fabs(rejectGap) <= kSelectionTolerance * std::max(selection.anchorReject, selection.skipReject);
+        bool skipFaster = tie ? selection.skipHit < selection.anchorHit : rejectGap > 0;
+        MatchEngine fastest = skipFaster ? MatchEngine::Horspool : MatchEngine::Anchor;
+        MatchEngine selected = selectMatchEngine(table, patch.size);
+        // Needles stalling on zero filled pages are anchor searched whatever their skip
+        if (zeroPages && skipFaster) {
+            skipMin = std::min(skipMin, skip);
+        } else if (zeroPages) {
+            anchorMax = std::max(anchorMax, skip);
+        }
+        if (fastest != selected) {
+            fprintf(stderr, "%s: %s selected, %s measured faster\n", patch.name, selected == MatchEngine::Horspool ? "skip" : "anchor",
+                    skipFaster ? "skip" : "anchor");
+            mismatches++;
+        }
+        printf("%s    {\"needle\": \"%s\", \"size\": %zu, \"expected_skip\": %zu, \"zero_pages\": %s, "
+               "\"anchor_reject_ns\": %.1f, \"anchor_hit_ns\": %.1f, \"skip_reject_ns\": %.1f, \"skip_hit_ns\": %.1f, "
+               "\"fastest\": \"%s\", \"selected\": \"%s\"}",
+               n > 0 ? ",\n" : "", patch.name, patch.size, skip, zeroPages ? "true" : "false", selection.anchorReject,
+               selection.anchorHit, selection.skipReject, selection.skipHit, skipFaster ? "skip" : "anchor",
+               selected == MatchEngine::Horspool ? "skip" : "anchor");
+    }
+    // kHorspoolMinSkip belongs above the largest expected skip measured faster with the anchor prefilter
+    // and at most the smallest one measured faster with the skip search
+    printf("\n  ],\n  \"crossover\": {\"anchor_max_skip\": %zu, \"skip_min_skip\": %zu, \"min_skip\": %zu, \"mismatches\": %zu}",
+           anchorMax, skipMin == SIZE_MAX ? 0 : skipMin, kHorspoolMinSkip, mismatches);
+}
+
+#pragma mark - Sequential baseline
+
+struct BenchVersion {
+    const char *name;
+    KernelVersion kernel;
+};
+
+// Versions whose shared cache patch sets are compared, checked against their latest minor release
+static const BenchVersion kBenchVersions[] {
+    {"catalina", KernelVersion::Catalina},
+    {"big_sur", KernelVersion::BigSur},
+    {"monterey", KernelVersion::Monterey},
+    {"ventura", KernelVersion::Ventura},
+};
+
+// Prints the sequential results of every version, returns false when both searches disagree
+static bool printSequential(const std::vector<Corpus> &corpora, size_t pages, size_t repeats) {
+    bool agree = true;
+    bool firstResult = true;
+    for (auto &version : kBenchVersions) {
+        uint32_t os = osVersion(version.kernel, 0xFF);
+        std::vector<Needle> needles;
+        MultiPatternMatcher matcher;
+        for (auto &patch : kPatchDescriptors) {
+            if (patch.target == PatchTarget::SharedCache && patch.minOs <= os && os <= patch.maxOs) {
+                needles.push_back({patch.name, patch.find, patch.findMask, patch.size, patch.anchor});
+                matcher.add(patch.pattern());
+            }
+        }
+        if (needles.empty()) {
+            continue;
+        }
+        // Lilu's findAndReplace, a full compare at every position, once per patch
+        std::vector<NaiveEngine> sequential(needles.size());
+        for (size_t n = 0; n < needles.size(); n++) {
+            sequential[n].prepare(needles[n]);
+        }
+        uint32_t enabled = static_cast<uint32_t>((1ULL << needles.size()) - 1);
+        Corpus hit = makeHitCorpus(needles.data(), needles.size(), pages, static_cast<uint32_t>(300 + version.kernel));
+        for (size_t c = 0; c <= corpora.size(); c++) {
+            const Corpus &corpus = c < corpora.size() ? corpora[c] : hit;
+            Measurement baseline = measurePages(corpus, repeats, [&](const uint8_t *data, size_t size) {
+                size_t found = 0;
+                for (auto &engine : sequential) {
+                    found += engine.count(data, size);
+                }
+                return found;
+            });
+            Measurement single = measurePages(corpus, repeats, [&](const uint8_t *data, size_t size) {
+                size_t found = 0;
+                matcher.scan(data, size, enabled, [&](size_t, size_t) { found++; });
+                return found;
+            });
+            if (baseline.matches != single.matches) {
+                fprintf(stderr, "%s %s: %zu sequential matches, %zu single pass matches\n", version.name, corpus.name.c_str(),
+                        baseline.matches, single.matches);
+                agree = false;
+            }
+            printf("%s    {\"os\": \"%s\", \"patches\": %zu, \"corpus\": \"%s\", \"sequential_ns\": %.1f, "
+                   "\"single_pass_ns\": %.1f, \"speedup\": %.1f, \"matches\": %zu}",
+                   firstResult ? "" : ",\n", version.name, needles.size(), corpus.name.c_str(), baseline.nsPerPage,
+                   single.nsPerPage, baseline.nsPerPage / single.nsPerPage, single.matches);
+            firstResult = false;
+        }
+    }
+    return agree;
+}
+
+static void usage(const char *name) {
+    fprintf(stderr, "Usage: %s [-p pages] [-r repeats] [-f file] [-s]\n", name);
+    fprintf(stderr, "  -p  pages per corpus (default 256)\n");
+    fprintf(stderr, "  -r  repeats, the fastest is reported (default 5)\n");
+    fprintf(stderr, "  -f  also measure the pages of a file\n");
+    fprintf(stderr, "  -s  compare sequential findAndReplace passes with the single pass matcher\n");
+}
+
+int main(int argc, char *argv[]) {
+    size_t pages = 256;
+    size_t repeats = 5;
+    const char *file = nullptr;
+    bool sequential = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "p:r:f:s")) != -1) {
+        switch (opt) {
+            case 'p':
+                pages = std::max<size_t>(strtoul(optarg, nullptr, 0), 1);
+                break;
+            case 'r':
+                repeats = std::max<size_t>(strtoul(optarg, nullptr, 0), 1);
+                break;
+            case 'f':
+                file = optarg;
+                break;
+            case 's':
+                sequential = true;
+                break;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<Corpus> corpora;
+    corpora.push_back(makeCorpus("cstring", pages, fillCstringPage, 1));
+    corpora.push_back(makeCorpus("code", pages, fillCodePage, 2));
+    corpora.push_back(makeCorpus("zero", pages, nullptr, 3));
+    if (file) {
+        Corpus corpus;
+        if (!loadFileCorpus(file, pages * 64, corpus)) {
+            return EXIT_FAILURE;
+        }
+        corpora.push_back(std::move(corpus));
+    }
+
+    NaiveEngine naive;
+    HorspoolEngine horspool;
+    MemchrEngine memchrEngine;
+    SwarEngine swar;
+    SkipEngine skip;
+#ifdef __SSE2__
+    SimdEngine simd;
+#endif
+    AutomatonEngine automaton;
+    Engine *engines[] {
+        &naive, &horspool, &memchrEngine, &swar, &skip,
+#ifdef __SSE2__
+        &simd,
+#endif
+        &automaton,
+    };
+
+    printf("{\n  \"page_size\": %zu,\n  \"pages\": %zu,\n  \"engines\": [", kBenchPageSize, pages);
+    for (size_t e = 0; e < arrsize(engines); e++) {
+        printf("%s\"%s\"", e > 0 ? ", " : "", engines[e]->name());
+    }
+    printf("],\n  \"results\": [\n");
+    bool firstResult = true;
+    Selection selections[arrsize(kPatchDescriptors)] {};
+    for (size_t n = 0; n < arrsize(kPatchDescriptors); n++) {
+        const PatchDescriptor &patch = kPatchDescriptors[n];
+        Needle needle {patch.name, patch.find, patch.findMask, patch.size, patch.anchor};
+        Corpus hit = makeHitCorpus(needle, pages, static_cast<uint32_t>(100 + n));
+        for (auto engine : engines) {
+            engine->prepare(needle);
+            for (size_t c = 0; c <= corpora.size(); c++) {
+                const Corpus &corpus = c < corpora.size() ? corpora[c] : hit;
+                Measurement m = measure(*engine, corpus, repeats);
+                printf("%s    {\"needle\": \"%s\", \"size\": %zu, \"masked\": %s, \"corpus\": \"%s\", \"engine\": \"%s\", "
+                       "\"ns_per_page\": %.1f, \"gb_per_s\": %.3f, \"matches\": %zu}",
+                       firstResult ? "" : ",\n", needle.name, needle.size, needle.mask ? "true" : "false", corpus.name.c_str(),
+                       engine->name(), m.nsPerPage, kBenchPageSize / m.nsPerPage, m.matches);
+                firstResult = false;
+                // Reject-only synthetic corpora, the file may hold hits
+                if (engine == &swar || engine == &skip) {
+                    Selection &selection = selections[n];
+                    double &reject = engine == &swar ? selection.anchorReject : selection.skipReject;
+                    double &hitNs = engine == &swar ? selection.anchorHit : selection.skipHit;
+                    if (c < 3) {
+                        reject += m.nsPerPage / 3;
+                    } else if (c == corpora.size()) {
+                        hitNs = m.nsPerPage;
+                    }
+                }
+            }
+        }
+    }
+    printSelection(selections);
+    printf(",\n  \"masked_verify\": [\n");
+    firstResult = true;
+    for (size_t n = 0; n < arrsize(kPatchDescriptors); n++) {
+        const PatchDescriptor &patch = kPatchDescriptors[n];
+        if (!patch.findMask) {
+            continue;
+        }
+        Needle needle {patch.name, patch.find, patch.findMask, patch.size, patch.anchor};
+        MatchPattern pattern = patch.pattern();
+        auto candidates = makeCandidates(needle, static_cast<uint32_t>(200 + n));
+        Measurement bytewise = measureVerify(candidates, needle.size, repeats * 20, [&](const uint8_t *data) {
+            return verifyNeedle(data, needle);
+        });
+        Measurement word = measureVerify(candidates, needle.size, repeats * 20, [&](const uint8_t *data) {
+            return matchPattern(data, pattern, 0, pattern.size);
+        });
+        printf("%s    {\"needle\": \"%s\", \"size\": %zu, \"candidates\": %zu, \"matches\": %zu, "
+               "\"bytewise_ns\": %.2f, \"word_ns\": %.2f}",
+               firstResult ? "" : ",\n", needle.name, needle.size, kVerifyCandidates, word.matches, bytewise.nsPerPage, word.nsPerPage);
+        firstResult = false;
+    }
+    bool agree = true;
+    if (sequential) {
+        printf("\n  ],\n  \"sequential\": [\n");
+        agree = printSequential(corpora, pages, repeats);
+    }
+    printf("\n  ]\n}\n");
+    return agree ? EXIT_SUCCESS : EXIT_FAILURE;
+}
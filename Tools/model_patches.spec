@@ -0,0 +1,198 @@
+#
+#  model_patches.spec
+#  FeatureUnlock
+#
+#  Copyright © 2026 acidanthera. All rights reserved.
+#
+
+# Model list patch sets, compiled by Tools/patch_gen.cpp into FeatureUnlock/kern_model_patch_data.hpp.
+# See kern_dyld_patch.hpp and kern_usr_patch.hpp for why each list is patched.
+#
+# patch <Name>           starts a patch set, tables are named k<Name>Original, k<Name>Patched, ...
+#   title <text>         name shown in kern.featureunlock
+#   target <target>      PatchTarget: SharedCache, UniversalControl or ControlCenter
+#   features <mask>      PatchFeature mask
+#   classes <mask>       ModelClass mask of the hosts needing the patch, 0 for every host
+#   os <min> <max>       kernel range as Name[.minor], max defaults to its last minor or is latest
+#   once                 stop looking for the patch once applied
+#   rewrite <from>>...   substitutions applied in order to every model, from and to of equal length
+#   models <model>...    NUL separated model identifiers, may be repeated
+#   unterminated         the last model is matched without its NUL terminator
+#                        a last model ending with * is matched up to the * only
+#   overlaps <Name>...   patch sets whose matches may overlap with this one, as a known exception
+#
+# Every model must be changed by the rewrite. Patch sets sharing a target and an OS version
+# must not share a model, nor match overlapping bytes unless listed by overlaps, nor match
+# their own or each other's replacement. Mac is rewritten as Nac by replacing every M, thus MacMini8,1 becomes NacNini8,1.
+
+# Sidecar, Catalina
+
+patch SideCarAirPlayMacBookPro
+    title Sidecar (MacBookPro)
+    target SharedCache
+    features FeatureSidecar
+    classes kModelsSidecarMacBookPro
+    os Catalina Catalina
+    rewrite M>N
+    models MacBookPro9,1 MacBookPro9,2 MacBookPro10,1 MacBookPro10,2
+    models MacBookPro11,1 MacBookPro11,2 MacBookPro11,3 MacBookPro11,4 MacBookPro11,5 MacBookPro12,1
+
+patch SideCarAirPlayMacBook
+    title Sidecar (MacBook/MacBookAir)
+    target SharedCache
+    features FeatureSidecar
+    classes kModelsSidecarMacBook
+    os Catalina Catalina
+    rewrite M>N
+    models MacBook8,1
+    models MacBookAir5,1 MacBookAir5,2 MacBookAir6,1 MacBookAir6,2 MacBookAir7,1 MacBookAir7,2
+
+patch SideCarAirPlayiMac
+    title Sidecar (iMac)
+    target SharedCache
+    features FeatureSidecar
+    classes kModelsSidecariMac
+    os Catalina Catalina
+    rewrite M>N
+    models iMac13,1 iMac13,2 iMac13,3 iMac14,1 iMac14,2 iMac14,3 iMac14,4 iMac15,1 iMac16,1 iMac16,2
+
+patch SideCarAirPlayStandaloneDesktop
+    title Sidecar (Macmini/MacPro)
+    target SharedCache
+    features FeatureSidecar
+    classes kModelsSidecarDesktop
+    os Catalina Catalina
+    rewrite M>N
+    models Macmini6,1 Macmini6,2 Macmini7,1
+    models MacPro5,1 MacPro6,1
+    unterminated
+
+# Sidecar and AirPlay to Mac, Big Sur and newer
+
+patch SideCarAirPlayMacBookPro2012
+    title Sidecar/AirPlay (MacBook Pro 2012)
+    target SharedCache
+    features FeatureSidecar | FeatureAirPlay
+    classes ModelMacBookPro2012
+    os BigSur latest
+    rewrite M>N
+    models MacBookPro9,1 MacBookPro9,2 MacBookPro10,1 MacBookPro10,2
+
+patch SideCarAirPlayMacBookPro2013_2015
+    title Sidecar/AirPlay (MacBook Pro 2013 - 2015)
+    target SharedCache
+    features FeatureSidecar | FeatureAirPlay
+    classes ModelMacBookPro2013 | ModelMacBookPro2015
+    os BigSur latest
+    rewrite M>N
+    models MacBookPro11,1 MacBookPro11,2 MacBookPro11,3 MacBookPro11,4 MacBookPro11,5 MacBookPro12,1
+
+patch SideCarAirPlayMacBookMacBookAir2012
+    title Sidecar/AirPlay (MacBook 2015/MacBook Air 2012)
+    target SharedCache
+    features FeatureSidecar | FeatureAirPlay
+    classes ModelMacBook2015 | ModelMacBookAir2012
+    os BigSur latest
+    rewrite M>N
+    models MacBook8,1
+    models MacBookAir5,1 MacBookAir5,2
+
+patch SideCarAirPlayMacBookAir2013_2015
+    title Sidecar/AirPlay (MacBook Air 2013 - 2015)
+    target SharedCache
+    features FeatureSidecar | FeatureAirPlay
+    classes ModelMacBookAir2013 | ModelMacBookAir2015
+    os BigSur latest
+    rewrite M>N
+    models MacBookAir6,1 MacBookAir6,2 MacBookAir7,1 MacBookAir7,2
+
+patch SideCarAirPlayiMacAlternative2012
+    title Sidecar/AirPlay (iMac 2012)
+    target SharedCache
+    features FeatureSidecar | FeatureAirPlay
+    classes ModeliMac2012
+    os BigSur latest
+    rewrite M>N
+    models iMac13,1 iMac13,2 iMac13,3
+
+patch SideCarAirPlayiMacAlternative2013
+    title Sidecar/AirPlay (iMac 2013)
+    target SharedCache
+    features FeatureSidecar | FeatureAirPlay
+    classes ModeliMac2013
+    os BigSur latest
+    rewrite M>N
+    models iMac14,1 iMac14,2 iMac14,3 iMac14,4
+
+patch SideCarAirPlayiMacAlternative2014
+    title Sidecar/AirPlay (iMac 2014)
+    target SharedCache
+    features FeatureSidecar | FeatureAirPlay
+    classes ModeliMac2014 | ModeliMac2015Broadwell
+    os BigSur latest
+    rewrite M>N
+    models iMac15,1 iMac16,1 iMac16,2
+
+patch SideCarAirPlayMacmini
+    title Sidecar/AirPlay (Mac mini 2012 - 2014)
+    target SharedCache
+    features FeatureSidecar | FeatureAirPlay
+    classes ModelMacmini2012 | ModelMacmini2014
+    os BigSur latest
+    rewrite M>N
+    models Macmini6,1 Macmini6,2 Macmini7,1
+
+patch SideCarAirPlayMacPro
+    title Sidecar/AirPlay (Mac Pro 2010 - 2013)
+    target SharedCache
+    features FeatureSidecar | FeatureAirPlay
+    classes ModelMacPro2013 | ModelMacPro2010_2012
+    os BigSur latest
+    rewrite M>N
+    models MacPro5,1 MacPro6,1
+    unterminated
+
+patch MacModelAirplayExtended
+    title AirPlay to Mac (Extended)
+    target SharedCache
+    features FeatureAirPlay
+    classes kModelsAirPlayExtended
+    os Monterey latest
+    rewrite M>N
+    models iMac17,1 iMac18,1 iMac18,2 iMac18,3
+    models MacBookPro13,1 MacBookPro13,2 MacBookPro13,3 MacBookPro14,1 MacBookPro14,2 MacBookPro14,3
+    # 12.0 - 12.3 B1 is MacMini8,1, 12.3 B2+ is Macmini8,1
+    models Mac*
+    # The Mac prefix could run into a Big Sur list, the registry order decides which one is patched
+    overlaps SideCarAirPlayMacBookPro2012 SideCarAirPlayMacBookPro2013_2015 SideCarAirPlayMacBookMacBookAir2012
+    overlaps SideCarAirPlayMacBookAir2013_2015 SideCarAirPlayMacmini SideCarAirPlayMacPro
+
+# Sidecar iPad check
+
+patch SidecariPadModel
+    title Sidecar (iPad)
+    target SharedCache
+    features FeatureSidecariPad
+    classes 0
+    os Catalina latest
+    once
+    rewrite iPad>hPad
+    models iPad4,1 iPad4,2 iPad4,3 iPad4,4 iPad4,5 iPad4,6 iPad4,7 iPad4,8 iPad4,9
+    models iPad5,1 iPad5,2 iPad5,3 iPad5,4 iPad6,11 iPad6,12
+    unterminated
+
+# Universal Control lives outside of the shared cache
+
+patch UniversalControl
+    title Universal Control (app)
+    target UniversalControl
+    features FeatureUniversalControl
+    classes kModelsUniversalControl
+    os Monterey.4 latest
+    rewrite M>N iPad>iQad
+    models iMac16,1 iMac16,2
+    models iPad5,1 iPad5,2 iPad5,3 iPad5,4 iPad6,11 iPad6,12
+    models MacBookAir7,1 MacBookAir7,2
+    models MacBookPro11,4 MacBookPro11,5 MacBookPro12,1
+    models Macmini7,1 MacPro6,1
+    unterminated
@@ -0,0 +1,303 @@
+//
+//  model_test.cpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+// Host test of the model detection, comparing the model class detectMachineProperties
+// assigns with the per class strstr/strncmp lists it replaced, for every listed model
+// identifier, near misses of them and identifiers with garbage on the end. The kext
+// sources are built into the test, as detectMachineProperties is not exported.
+// Both classifiers are timed over the same identifiers afterwards.
+//
+// Build from the repository root:
+//   c++ -std=gnu++14 -O2 -pthread -ITools/Shim -DPRODUCT_NAME=FeatureUnlock -DMODULE_VERSION=1.1.8
+//       Tools/Shim/kern_shim.cpp Tools/model_test.cpp -o model_test
+//
+// Usage:
+//   model_test [-r repeats]
+//
+// Exits with a failure when any identifier is classified differently.
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Shim/kern_shim.hpp"
+#include "../FeatureUnlock/kern_start.cpp"
+
+#pragma mark - Baseline Classifier
+
+// Model lists as matched before the range table
+static const char *kBaselineMacBookLegacy[] {"MacBook4,1", "MacBook5,1", "MacBook5,2", "MacBook6,1", "MacBook7,1"};
+static const char *kBaselineMacBookModern[] {"MacBook8,1"};
+static const char *kBaselineMacBookAirLegacy[] {"MacBookAir2,1", "MacBookAir3,1", "MacBookAir3,2", "MacBookAir4,1", "MacBookAir4,2"};
+static const char *kBaselineMacBookAir2012[] {"MacBookAir5,1", "MacBookAir5,2"};
+static const char *kBaselineMacBookAir2013[] {"MacBookAir6,1", "MacBookAir6,2"};
+static const char *kBaselineMacBookAir2015[] {"MacBookAir7,1", "MacBookAir7,2"};
+static const char *kBaselineMacBookProLegacy[] {
+    "MacBookPro4,1", "MacBookPro5,1", "MacBookPro5,2", "MacBookPro5,3", "MacBookPro5,4", "MacBookPro5,5",
+    "MacBookPro6,1", "MacBookPro6,2", "MacBookPro7,1", "MacBookPro8,1", "MacBookPro8,2", "MacBookPro8,3",
+};
+static const char *kBaselineMacBookPro2012[] {"MacBookPro9,1", "MacBookPro9,2", "MacBookPro10,1", "MacBookPro10,2"};
+static const char *kBaselineMacBookPro2013[] {"MacBookPro11,1", "MacBookPro11,2", "MacBookPro11,3"};
+static const char *kBaselineMacBookPro2015[] {"MacBookPro11,4", "MacBookPro11,5", "MacBookPro12,1"};
+static const char *kBaselineMacBookPro2016[] {"MacBookPro13,1", "MacBookPro13,2", "MacBookPro13,3"};
+static const char *kBaselineMacBookPro2017[] {"MacBookPro14,1", "MacBookPro14,2", "MacBookPro14,3"};
+static const char *kBaselineiMacLegacy[] {
+    "iMac7,1", "iMac8,1", "iMac9,1", "iMac10,1", "iMac11,1", "iMac11,2", "iMac11,3", "iMac12,1", "iMac12,2",
+};
+static const char *kBaselineiMac2012[] {"iMac13,1", "iMac13,2", "iMac13,3"};
+static const char *kBaselineiMac2013[] {"iMac14,1", "iMac14,2", "iMac14,3", "iMac14,4"};
+static const char *kBaselineiMac2014[] {"iMac15,1"};
+static const char *kBaselineiMac2015Broadwell[] {"iMac16,1", "iMac16,2"};
+static const char *kBaselineiMac2015_2017[] {"iMac17,1", "iMac18,1", "iMac18,2", "iMac18,3"};
+static const char *kBaselineMacProLegacy[] {"MacPro3,1", "MacPro4,1", "MacPro5,1"};
+static const char *kBaselineMacPro2010_2012[] {"MacPro5,1"};
+static const char *kBaselineMacPro2013[] {"MacPro6,1"};
+static const char *kBaselineMacminiLegacy[] {"Macmini3,1", "Macmini4,1", "Macmini5,1", "Macmini5,2", "Macmini5,3"};
+static const char *kBaselineMacmini2012[] {"Macmini6,1", "Macmini6,2"};
+static const char *kBaselineMacmini2014[] {"Macmini7,1"};
+static const char *kBaselineMacmini2018[] {"Macmini8,1"};
+
+struct BaselineList {
+    const char **models;
+    size_t count;
+    ModelClass cls;
+};
+
+#define BASELINE_LIST(list, cls) {list, arrsize(list), cls}
+
+static const BaselineList kBaselineMacBook[] {
+    BASELINE_LIST(kBaselineMacBookLegacy, ModelMacBookPre2015),
+    BASELINE_LIST(kBaselineMacBookModern, ModelMacBook2015),
+};
+static const BaselineList kBaselineMacBookAir[] {
+    BASELINE_LIST(kBaselineMacBookAirLegacy, ModelMacBookAirPre2012),
+    BASELINE_LIST(kBaselineMacBookAir2012, ModelMacBookAir2012),
+    BASELINE_LIST(kBaselineMacBookAir2013, ModelMacBookAir2013),
+    BASELINE_LIST(kBaselineMacBookAir2015, ModelMacBookAir2015),
+};
+static const BaselineList kBaselineMacBookPro[] {
+    BASELINE_LIST(kBaselineMacBookProLegacy, ModelMacBookProPre2012),
+    BASELINE_LIST(kBaselineMacBookPro2012, ModelMacBookPro2012),
+    BASELINE_LIST(kBaselineMacBookPro2013, ModelMacBookPro2013),
+    BASELINE_LIST(kBaselineMacBookPro2015, ModelMacBookPro2015),
+    BASELINE_LIST(kBaselineMacBookPro2016, ModelMacBookPro2016),
+    BASELINE_LIST(kBaselineMacBookPro2017, ModelMacBookPro2017),
+};
+static const BaselineList kBaselineiMac[] {
+    BASELINE_LIST(kBaselineiMacLegacy, ModeliMacPre2012),
+    BASELINE_LIST(kBaselineiMac2012, ModeliMac2012),
+    BASELINE_LIST(kBaselineiMac2013, ModeliMac2013),
+    BASELINE_LIST(kBaselineiMac2014, ModeliMac2014),
+    BASELINE_LIST(kBaselineiMac2015Broadwell, ModeliMac2015Broadwell),
+    BASELINE_LIST(kBaselineiMac2015_2017, ModeliMac2015_2017),
+};
+static const BaselineList kBaselineMacmini[] {
+    BASELINE_LIST(kBaselineMacminiLegacy, ModelMacminiPre2012),
+    BASELINE_LIST(kBaselineMacmini2012, ModelMacmini2012),
+    BASELINE_LIST(kBaselineMacmini2014, ModelMacmini2014),
+    BASELINE_LIST(kBaselineMacmini2018, ModelMacmini2018),
+};
+static const BaselineList kBaselineMacPro[] {
+    BASELINE_LIST(kBaselineMacProLegacy, ModelMacProPre2010),
+    BASELINE_LIST(kBaselineMacPro2010_2012, ModelMacPro2010_2012),
+    BASELINE_LIST(kBaselineMacPro2013, ModelMacPro2013),
+};
+
+static bool baselineMatch(const char *identifier, const BaselineList &list) {
+    for (size_t i = 0; i < list.count; i++) {
+        if (strncmp(identifier, list.models[i], strlen(list.models[i])) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <size_t N>
+static ModelClass baselineMatch(const char *identifier, const BaselineList (&lists)[N]) {
+    for (auto &list : lists) {
+        if (baselineMatch(identifier, list)) {
+            return list.cls;
+        }
+    }
+    return ModelUnknown;
+}
+
+// Family picked by substrings anywhere in the identifier, then the first list with a prefix match
+static ModelClass baselineClassify(const char *identifier) {
+    if (strstr(identifier, "Book")) {
+        if (strstr(identifier, "Pro")) {
+            return baselineMatch(identifier, kBaselineMacBookPro);
+        } else if (strstr(identifier, "Air")) {
+            return baselineMatch(identifier, kBaselineMacBookAir);
+        }
+        return baselineMatch(identifier, kBaselineMacBook);
+    } else if (strstr(identifier, "mini")) {
+        return baselineMatch(identifier, kBaselineMacmini);
+    } else if (strstr(identifier, "Pro")) {
+        // Mac Pro 2010-2012 is looked up within the legacy models
+        auto &legacy = kBaselineMacPro[0], &mid2010 = kBaselineMacPro[1], &late2013 = kBaselineMacPro[2];
+        if (baselineMatch(identifier, legacy)) {
+            return baselineMatch(identifier, mid2010) ? mid2010.cls : legacy.cls;
+        }
+        return baselineMatch(identifier, late2013) ? late2013.cls : ModelUnknown;
+    } else if (strstr(identifier, "iMac")) {
+        return baselineMatch(identifier, kBaselineiMac);
+    }
+    return ModelUnknown;
+}
+
+static ModelClass rangeClassify(const char *identifier) {
+    ModelIdentifier model;
+    const ModelRange *range = parseModelIdentifier(identifier, model) ? lookupModelRange(model) : nullptr;
+    return range ? range->cls : ModelUnknown;
+}
+
+#pragma mark - Identifiers
+
+static const char *kFamilies[] {"iMac", "MacBook", "MacBookAir", "MacBookPro", "Macmini", "MacPro"};
+
+// Garbage found on the end of identifiers. The baseline picked the family by substrings
+// anywhere in the identifier, so garbage spelling Book, Air, Pro, mini or iMac changed the
+// family it was looked up in, this is not preserved and not covered.
+static const char *kSuffixes[] {"DvcPtsupre", "0", "9", ",1", "_", " ", "x", "\xff"};
+
+static const char *kNearMisses[] {
+    "", "Mac", "iMac", "MacBookPro", "MacBookPro,1", "MacBookPro13", "MacBookPro13,", "MacBookPro13,x",
+    "iMac7,10", "iMac07,1", "iMac7,01", "iMac13,1 ", "MacBookPro11,40", "MacBookPro011,4", "MacBookPro1234,1",
+    "MacBookPro12345,1", "MacBookPro4294967297,1", "MacPro5,1", "MacPro5,10", "MacPro5,2", "MacPro4,2",
+    "MacPro6,1", "MacPro7,1", "iMacPro1,1", "Macmini8,1", "macmini8,1", "MacBookAir10,1", "Mac13,1",
+    "VMware7,1", "XMacBookPro11,4", "MacBook", "MacBook8,1", "MacBook10,1",
+};
+
+static std::vector<std::string> collectIdentifiers() {
+    std::vector<std::string> identifiers;
+    auto addLists = [&identifiers](const BaselineList *lists, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            for (size_t j = 0; j < lists[i].count; j++) {
+                identifiers.emplace_back(lists[i].models[j]);
+                for (auto suffix : kSuffixes) {
+                    identifiers.emplace_back(std::string(lists[i].models[j]) + suffix);
+                }
+            }
+        }
+    };
+    addLists(kBaselineMacBook, arrsize(kBaselineMacBook));
+    addLists(kBaselineMacBookAir, arrsize(kBaselineMacBookAir));
+    addLists(kBaselineMacBookPro, arrsize(kBaselineMacBookPro));
+    addLists(kBaselineiMac, arrsize(kBaselineiMac));
+    addLists(kBaselineMacmini, arrsize(kBaselineMacmini));
+    addLists(kBaselineMacPro, arrsize(kBaselineMacPro));
+
+    // Every family with majors around the lookup table and single or double digit minors
+    char identifier[48];
+    for (auto family : kFamilies) {
+        for (uint32_t major = 0; major <= kModelMaxMajor + 1; major++) {
+            for (uint32_t minor = 0; minor <= 12; minor++) {
+                snprintf(identifier, sizeof(identifier), "%s%u,%u", family, major, minor);
+                identifiers.emplace_back(identifier);
+            }
+        }
+    }
+    for (auto nearMiss : kNearMisses) {
+        identifiers.emplace_back(nearMiss);
+    }
+    return identifiers;
+}
+
+#pragma mark - Test
+
+// detectMachineProperties logs every model, stderr is muted while it runs
+static bool compareDetection(const std::vector<std::string> &identifiers) {
+    fflush(stderr);
+    int saved = dup(STDERR_FILENO);
+    int null = open("/dev/null", O_WRONLY);
+    if (saved < 0 || null < 0) {
+        fprintf(stderr, "failed to mute stderr\n");
+        return false;
+    }
+
+    std::vector<std::pair<size_t, ModelClass>> mismatches;
+    for (size_t i = 0; i < identifiers.size(); i++) {
+        strncpy(shimHost().model, identifiers[i].c_str(), sizeof(shimHost().model) - 1);
+        host_model = ModelUnknown;
+        dup2(null, STDERR_FILENO);
+        detectMachineProperties();
+        fflush(stderr);
+        dup2(saved, STDERR_FILENO);
+        if (host_model != baselineClassify(identifiers[i].c_str())) {
+            mismatches.push_back({i, host_model});
+        }
+    }
+    close(null);
+    close(saved);
+
+    for (auto &mismatch : mismatches) {
+        auto &identifier = identifiers[mismatch.first];
+        fprintf(stderr, "%s: detected 0x%08X, baseline 0x%08X\n", identifier.c_str(), mismatch.second,
+                baselineClassify(identifier.c_str()));
+    }
+    printf("%zu identifiers, %zu mismatches\n", identifiers.size(), mismatches.size());
+    return mismatches.empty();
+}
+
+template <typename F>
+static double measure(const std::vector<std::string> &identifiers, size_t repeats, F classify) {
+    volatile uint32_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < repeats; r++) {
+        for (auto &identifier : identifiers) {
+            sink = sink + classify(identifier.c_str());
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (repeats * identifiers.size());
+}
+
+static void printTiming(const char *name, const std::vector<std::string> &identifiers, size_t repeats) {
+    double baseline = measure(identifiers, repeats, baselineClassify);
+    double ranges = measure(identifiers, repeats, rangeClassify);
+    printf("%-12s %6zu identifiers: baseline %7.1f ns, ranges %7.1f ns, speedup %.1fx\n", name, identifiers.size(),
+           baseline, ranges, baseline / ranges);
+}
+
+static void usage(const char *name) {
+    fprintf(stderr, "Usage: %s [-r repeats]\n", name);
+    fprintf(stderr, "  -r  timing passes over the identifiers (default 1000)\n");
+}
+
+int main(int argc, char *argv[]) {
+    size_t repeats = 1000;
+    int opt;
+    while ((opt = getopt(argc, argv, "r:")) != -1) {
+        switch (opt) {
+            case 'r':
+                repeats = std::max<size_t>(strtoul(optarg, nullptr, 0), 1);
+                break;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    auto identifiers = collectIdentifiers();
+    bool success = compareDetection(identifiers);
+
+    // Listed models alone are the common case, every other identifier falls through all lists
+    std::vector<std::string> listed;
+    std::copy_if(identifiers.begin(), identifiers.end(), std::back_inserter(listed), [](const std::string &identifier) {
+        return baselineClassify(identifier.c_str()) != ModelUnknown;
+    });
+    printTiming("classified", listed, repeats);
+    printTiming("all", identifiers, repeats);
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
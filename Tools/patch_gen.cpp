@@ -0,0 +1,457 @@
+//
+//  patch_gen.cpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+// Host tool compiling the model list patch sets of Tools/model_patches.spec into
+// FeatureUnlock/kern_model_patch_data.hpp: the original and patched tables, their match
+// anchors, skip tables for the patterns selectMatchEngine picks for a skip search, and the registry
+// descriptors. Diff spans are derived from the tables by patchDescriptor.
+// The spec is rejected, and nothing is written, when a model is not changed by its rewrite
+// or when patch sets active together share a model or may match overlapping bytes.
+//
+// Build from the repository root, -ITools/Shim provides the Lilu headers the matcher includes:
+//   c++ -std=gnu++14 -O2 -ITools/Shim Tools/patch_gen.cpp -o patch_gen
+//
+// Usage:
+//   patch_gen Tools/model_patches.spec > FeatureUnlock/kern_model_patch_data.hpp
+//
+// CI regenerates the header and fails when it differs from the committed one.
+
+#include <string>
+#include <vector>
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Headers/kern_util.hpp>
+#include "../FeatureUnlock/kern_matcher.hpp"
+
+static constexpr uint32_t kOsVersionLatest = UINT32_MAX;
+
+static const struct {
+    const char *name;
+    KernelVersion version;
+} kOsNames[] {
+    {"Sierra", KernelVersion::Sierra},
+    {"HighSierra", KernelVersion::HighSierra},
+    {"Mojave", KernelVersion::Mojave},
+    {"Catalina", KernelVersion::Catalina},
+    {"BigSur", KernelVersion::BigSur},
+    {"Monterey", KernelVersion::Monterey},
+    {"Ventura", KernelVersion::Ventura},
+    {"Sonoma", KernelVersion::Sonoma},
+    {"Sequoia", KernelVersion::Sequoia},
+};
+
+static const char *kTargets[] {"SharedCache", "UniversalControl", "ControlCenter"};
+
+struct OsBound {
+    std::string name;   // empty for latest
+    uint32_t minor;
+    uint32_t version;   // major and minor packed as osVersion does
+};
+
+struct ModelGroup {
+    std::vector<std::string> models;
+};
+
+struct PatchSpec {
+    std::string name;
+    size_t line;
+    std::string title;
+    std::string target;
+    std::string features;
+    std::string classes;
+    OsBound minOs;
+    OsBound maxOs;
+    bool once;
+    bool unterminated;
+    std::vector<std::pair<std::string, std::string>> rewrite;
+    std::vector<std::string> overlaps;  // patch sets whose matches may overlap, accepted as such
+    std::vector<ModelGroup> groups;
+    std::vector<std::string> models;
+    std::vector<std::string> patched;
+    std::vector<size_t> lengths;    // bytes of each model in the tables
+    std::vector<uint8_t> find;
+    std::vector<uint8_t> replace;
+};
+
+static std::vector<std::string> splitWords(const std::string &text) {
+    std::vector<std::string> words;
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && isspace(static_cast<unsigned char>(text[i]))) {
+            i++;
+        }
+        size_t start = i;
+        while (i < text.size() && !isspace(static_cast<unsigned char>(text[i]))) {
+            i++;
+        }
+        if (i > start) {
+            words.push_back(text.substr(start, i - start));
+        }
+    }
+    return words;
+}
+
+static std::string trim(const std::string &text) {
+    size_t start = text.find_first_not_of(" \t\r\n");
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return start == std::string::npos ? std::string() : text.substr(start, end - start + 1);
+}
+
+// Parses Name[.minor], minor defaulting to 0 for a lower bound and to the last one for an upper bound
+static bool parseOsBound(const std::string &text, bool upper, OsBound &bound) {
+    if (upper && text == "latest") {
+        bound = {"", 0, kOsVersionLatest};
+        return true;
+    }
+    size_t dot = text.find('.');
+    std::string name = text.substr(0, dot);
+    bound.minor = upper ? 0xFF : 0;
+    if (dot != std::string::npos) {
+        char *end = nullptr;
+        unsigned long minor = strtoul(text.c_str() + dot + 1, &end, 10);
+        if (*end != '\0' || minor > 0xFF) {
+            return false;
+        }
+        bound.minor = static_cast<uint32_t>(minor);
+    }
+    for (auto &os : kOsNames) {
+        if (name == os.name) {
+            bound.name = name;
+            bound.version = (static_cast<uint32_t>(os.version) << 8) | bound.minor;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseSpec(const char *path, std::vector<PatchSpec> &specs) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    bool success = true;
+    auto fail = [&](size_t line, const char *message, const std::string &detail) {
+        fprintf(stderr, "%s:%zu: %s%s%s\n", path, line, message, detail.empty() ? "" : ": ", detail.c_str());
+        success = false;
+    };
+
+    char buffer[1024];
+    size_t line = 0;
+    PatchSpec *spec = nullptr;
+    while (fgets(buffer, sizeof(buffer), file)) {
+        line++;
+        std::string text = trim(buffer);
+        if (text.empty() || text[0] == '#') {
+            continue;
+        }
+        std::vector<std::string> words = splitWords(text);
+        const std::string &key = words[0];
+        std::string value = trim(text.substr(key.size()));
+        if (key == "patch") {
+            if (words.size() != 2) {
+                fail(line, "patch takes a name", "");
+                continue;
+            }
+            for (auto &other : specs) {
+                if (other.name == words[1]) {
+                    fail(line, "duplicate patch", words[1]);
+                }
+            }
+            specs.push_back({});
+            spec = &specs.back();
+            spec->name = words[1];
+            spec->line = line;
+            continue;
+        }
+        if (!spec) {
+            fail(line, "expected patch", key);
+            continue;
+        }
+        if (key == "title") {
+            spec->title = value;
+        } else if (key == "target") {
+            spec->target = value;
+            bool known = false;
+            for (auto target : kTargets) {
+                known |= value == target;
+            }
+            if (!known) {
+                fail(line, "unknown target", value);
+            }
+        } else if (key == "features") {
+            spec->features = value;
+        } else if (key == "classes") {
+            spec->classes = value;
+        } else if (key == "os") {
+            if (words.size() != 3 || !parseOsBound(words[1], false, spec->minOs) || !parseOsBound(words[2], true, spec->maxOs) ||
+                spec->minOs.version > spec->maxOs.version) {
+                fail(line, "invalid OS range", value);
+            }
+        } else if (key == "once") {
+            spec->once = true;
+        } else if (key == "unterminated") {
+            spec->unterminated = true;
+        } else if (key == "rewrite") {
+            for (size_t i = 1; i < words.size(); i++) {
+                size_t arrow = words[i].find('>');
+                std::string from = words[i].substr(0, arrow);
+                std::string to = arrow == std::string::npos ? "" : words[i].substr(arrow + 1);
+                if (from.empty() || from.size() != to.size()) {
+                    fail(line, "rewrite needs from>to of equal length", words[i]);
+                    continue;
+                }
+                spec->rewrite.emplace_back(from, to);
+            }
+        } else if (key == "overlaps") {
+            spec->overlaps.insert(spec->overlaps.end(), words.begin() + 1, words.end());
+        } else if (key == "models") {
+            spec->groups.push_back({});
+            for (size_t i = 1; i < words.size(); i++) {
+                for (auto &model : spec->models) {
+                    if (model == words[i]) {
+                        fail(line, "duplicate model", words[i]);
+                    }
+                }
+                spec->groups.back().models.push_back(words[i]);
+                spec->models.push_back(words[i]);
+            }
+        } else {
+            fail(line, "unknown keyword", key);
+        }
+    }
+    fclose(file);
+
+    for (auto &spec : specs) {
+        if (spec.title.empty() || spec.target.empty() || spec.features.empty() || spec.classes.empty() ||
+            spec.maxOs.version == 0 || spec.rewrite.empty() || spec.models.empty()) {
+            fail(spec.line, "patch needs a title, target, features, classes, os, rewrite and models", spec.name);
+            continue;
+        }
+        for (size_t i = 0; i < spec.models.size(); i++) {
+            // A trailing * matches the model prefix only, the rest differs between builds
+            bool prefix = spec.models[i].back() == '*';
+            if (prefix && i + 1 < spec.models.size()) {
+                fail(spec.line, "only the last model may be a prefix", spec.models[i]);
+            }
+            std::string model = spec.models[i].substr(0, spec.models[i].size() - (prefix ? 1 : 0));
+            std::string patched = model;
+            for (auto &rule : spec.rewrite) {
+                for (size_t at = patched.find(rule.first); at != std::string::npos; at = patched.find(rule.first, at + rule.second.size())) {
+                    patched.replace(at, rule.first.size(), rule.second);
+                }
+            }
+            if (patched == model) {
+                fail(spec.line, "model is not changed by the rewrite", spec.models[i]);
+            }
+            spec.patched.push_back(patched + (prefix ? "*" : ""));
+            // Models are NUL separated, c_str() provides the terminator
+            size_t length = patched.size() + (!prefix && (!spec.unterminated || i + 1 < spec.models.size()) ? 1 : 0);
+            spec.lengths.push_back(length);
+            spec.find.insert(spec.find.end(), model.c_str(), model.c_str() + length);
+            spec.replace.insert(spec.replace.end(), patched.c_str(), patched.c_str() + length);
+        }
+        for (auto &name : spec.overlaps) {
+            bool known = false;
+            for (auto &other : specs) {
+                known |= other.name == name && &other != &spec;
+            }
+            if (!known) {
+                fail(spec.line, "unknown overlapping patch", name);
+            }
+        }
+        if (spec.find.size() > kBoundaryWindow + 1) {
+            fail(spec.line, "patch is too long to be matched across pages", spec.name);
+        }
+    }
+    return success;
+}
+
+// Whether needle a placed at shift relative to needle b agrees with it on every overlapping byte
+static bool overlaps(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b, long shift) {
+    long begin = shift > 0 ? shift : 0;
+    long end = shift + static_cast<long>(a.size()) < static_cast<long>(b.size()) ? shift + static_cast<long>(a.size()) : static_cast<long>(b.size());
+    for (long i = begin; i < end; i++) {
+        if (b[i] != a[i - shift]) {
+            return false;
+        }
+    }
+    return begin < end;
+}
+
+static bool overlapsAnywhere(const std::vector<uint8_t> &a, const std::vector<uint8_t> &b) {
+    for (long shift = 1 - static_cast<long>(a.size()); shift < static_cast<long>(b.size()); shift++) {
+        if (overlaps(a, b, shift)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool acceptsOverlap(const PatchSpec &spec, const PatchSpec &other) {
+    for (auto &name : spec.overlaps) {
+        if (name == other.name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Patch sets active together must each match distinct bytes, once
+static bool checkSpecs(const std::vector<PatchSpec> &specs) {
+    bool success = true;
+    for (size_t i = 0; i < specs.size(); i++) {
+        for (size_t j = i; j < specs.size(); j++) {
+            const PatchSpec &a = specs[i];
+            const PatchSpec &b = specs[j];
+            if (a.target != b.target || a.maxOs.version < b.minOs.version || b.maxOs.version < a.minOs.version) {
+                continue;
+            }
+            if (i != j) {
+                for (auto &model : a.models) {
+                    for (auto &other : b.models) {
+                        if (model == other) {
+                            fprintf(stderr, "%s and %s are active together and both patch %s\n", a.name.c_str(), b.name.c_str(), model.c_str());
+                            success = false;
+                        }
+                    }
+                }
+                if (overlapsAnywhere(a.find, b.find) && !acceptsOverlap(a, b) && !acceptsOverlap(b, a)) {
+                    fprintf(stderr, "%s and %s are active together and may match overlapping bytes\n", a.name.c_str(), b.name.c_str());
+                    success = false;
+                }
+                if (overlapsAnywhere(b.find, a.replace)) {
+                    fprintf(stderr, "%s matches bytes patched by %s\n", b.name.c_str(), a.name.c_str());
+                    success = false;
+                }
+            }
+            if (overlapsAnywhere(a.find, b.replace)) {
+                fprintf(stderr, "%s matches bytes patched by %s\n", a.name.c_str(), b.name.c_str());
+                success = false;
+            }
+        }
+    }
+    return success;
+}
+
+static void appendf(std::string &out, const char *format, ...) __attribute__((format(printf, 2, 3)));
+static void appendf(std::string &out, const char *format, ...) {
+    char buffer[1024];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    out += buffer;
+}
+
+static std::string describeByte(uint8_t b) {
+    char text[8];
+    if (b >= 0x20 && b < 0x7F && b != '\'' && b != '\\') {
+        snprintf(text, sizeof(text), "'%c'", b);
+    } else {
+        snprintf(text, sizeof(text), "0x%02X", b);
+    }
+    return text;
+}
+
+static std::string osExpression(const OsBound &bound, bool upper) {
+    if (bound.name.empty()) {
+        return "kOsVersionLatest";
+    }
+    std::string expression = "osVersion(KernelVersion::" + bound.name;
+    if (upper && bound.minor == 0xFF) {
+        expression += ", 0xFF";
+    } else if (bound.minor != 0) {
+        expression += ", " + std::to_string(bound.minor);
+    }
+    return expression + ")";
+}
+
+static void emitTable(std::string &out, const PatchSpec &spec, const char *suffix, const std::vector<std::string> &models,
+                      const std::vector<uint8_t> &bytes) {
+    appendf(out, "static const uint8_t k%s%s[] = {\n", spec.name.c_str(), suffix);
+    size_t index = 0;
+    for (auto &group : spec.groups) {
+        out += "    //";
+        for (size_t i = 0; i < group.models.size(); i++) {
+            appendf(out, " %s", models[index + i].c_str());
+        }
+        out += "\n";
+        index += group.models.size();
+    }
+    // One row per model
+    size_t offset = 0;
+    for (size_t length : spec.lengths) {
+        out += "   ";
+        for (size_t j = 0; j < length; j++) {
+            appendf(out, " 0x%02X,", bytes[offset + j]);
+        }
+        out += "\n";
+        offset += length;
+    }
+    out += "};\n";
+}
+
+static std::string emitHeader(const std::vector<PatchSpec> &specs) {
+    std::string out;
+    out += "//\n//  kern_model_patch_data.hpp\n//  FeatureUnlock\n//\n";
+    out += "//  Generated by Tools/patch_gen from Tools/model_patches.spec, do not edit.\n//\n\n";
+    out += "#ifndef kern_model_patch_data_hpp\n#define kern_model_patch_data_hpp\n";
+    for (auto &spec : specs) {
+        const char *name = spec.name.c_str();
+        size_t size = spec.find.size();
+        MatchAnchor anchor = selectAnchor(spec.find.data(), nullptr, size);
+        MatchSpan diff = diffSpan(spec.find.data(), nullptr, spec.replace.data(), nullptr, size);
+        SkipTable table = buildSkipTable(spec.find.data(), nullptr, size);
+        bool skip = selectMatchEngine(table, size) == MatchEngine::Horspool;
+
+        appendf(out, "\n#pragma mark - %s\n\n", spec.title.c_str());
+        appendf(out, "// %zu bytes, anchored on %s at %u and %s at %u", size, describeByte(spec.find[anchor.first]).c_str(), anchor.first,
+                describeByte(spec.find[anchor.second]).c_str(), anchor.second);
+        if (skip) {
+            appendf(out, ", skip searched probing %s at %u", describeByte(spec.find[table.probe]).c_str(), table.probe);
+        }
+        appendf(out, ", writes bytes %u - %u\n", diff.begin, diff.end - 1);
+        emitTable(out, spec, "Original", spec.models, spec.find);
+        out += "\n";
+        emitTable(out, spec, "Patched", spec.patched, spec.replace);
+        out += "\n";
+        appendf(out, "static constexpr MatchAnchor k%sAnchor = selectAnchor(k%sOriginal);\n", name, name);
+        if (skip) {
+            appendf(out, "static constexpr SkipTable k%sSkip = buildSkipTable(k%sOriginal);\n", name, name);
+        }
+        appendf(out, "static constexpr PatchDescriptor k%sDescriptor =\n", name);
+        appendf(out, "    patchDescriptor(\"%s\", PatchTarget::%s, %s, %s,\n", spec.title.c_str(), spec.target.c_str(),
+                spec.features.c_str(), spec.classes.c_str());
+        appendf(out, "                    %s, %s, %s,\n", osExpression(spec.minOs, false).c_str(), osExpression(spec.maxOs, true).c_str(),
+                spec.once ? "true" : "false");
+        appendf(out, "                    k%sOriginal, k%sPatched, k%sAnchor%s%s%s);\n", name, name, name,
+                skip ? ", k" : "", skip ? name : "", skip ? "Skip" : "");
+    }
+    out += "\n#endif /* kern_model_patch_data_hpp */\n";
+    return out;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s spec > FeatureUnlock/kern_model_patch_data.hpp\n", argv[0]);
+        fprintf(stderr, "Build with -ITools/Shim from the repository root for the Lilu headers\n");
+        return EXIT_FAILURE;
+    }
+    std::vector<PatchSpec> specs;
+    if (!parseSpec(argv[1], specs) || !checkSpecs(specs)) {
+        return EXIT_FAILURE;
+    }
+    // Written at once, nothing is written for a rejected spec
+    std::string header = emitHeader(specs);
+    fwrite(header.data(), 1, header.size(), stdout);
+    return EXIT_SUCCESS;
+}
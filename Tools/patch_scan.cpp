@@ -0,0 +1,350 @@
+//
+//  patch_scan.cpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+// Host tool locating FeatureUnlock patch sets in a dyld shared cache or in the
+// UniversalControl and ControlCenter binaries, using the same registry and matcher
+// as the kext. For every patch set it lists every match offset, its page index and
+// whether the match straddles a page boundary (thus relying on split page fixups).
+//
+// Build from the repository root:
+//   c++ -std=gnu++14 -O2 -pthread -ITools/Shim Tools/patch_scan.cpp -o patch_scan
+//
+// Usage:
+//   patch_scan [-a] [-r] [-j threads] [-p page_size] file...
+//
+// Patch sets are selected by file name (dyld_shared_cache*, UniversalControl,
+// ControlCenter), -a looks for every patch set in every file.
+// -r maps the target images of shared caches and the target sections of binaries as the
+// kext does, listing their ranges and flagging matches outside of them, which the kext
+// would never scan. Sub caches are mapped from the main cache passed before them, as the
+// shell sorts them.
+
+#include <atomic>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../FeatureUnlock/kern_patch_set.hpp"
+#include "../FeatureUnlock/kern_cache_map.hpp"
+
+// Files are split into blocks handed out to the worker threads
+static constexpr size_t kScanBlockSize = 8 * 1024 * 1024;
+
+struct ScanMatch {
+    uint32_t patch;     // registry index
+    size_t offset;
+};
+
+struct ScanOptions {
+    bool allPatches {false};
+    bool mapRanges {false};
+    size_t threads {0};
+    size_t pageSize {4096};
+};
+
+static bool targetFromPath(const char *path, PatchTarget &target) {
+    const char *name = strrchr(path, '/');
+    name = name ? name + 1 : path;
+    if (strncmp(name, "dyld_shared_cache", strlen("dyld_shared_cache")) == 0) {
+        target = PatchTarget::SharedCache;
+    } else if (strcmp(name, "UniversalControl") == 0) {
+        target = PatchTarget::UniversalControl;
+    } else if (strcmp(name, "ControlCenter") == 0) {
+        target = PatchTarget::ControlCenter;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Matches are looked for block by block, each block extended by the longest pattern so
+// that matches crossing into the next block are found, but only those starting within it are kept
+static std::vector<ScanMatch> scanBuffer(const uint8_t *data, size_t size, const MultiPatternMatcher &matcher,
+                                         const uint32_t *registryIndex, size_t overlap, size_t threadCount) {
+    size_t blockCount = (size + kScanBlockSize - 1) / kScanBlockSize;
+    std::atomic<size_t> nextBlock {0};
+    std::vector<std::vector<ScanMatch>> found(threadCount);
+    uint32_t enabled = matcher.size() == kMaxMatchPatterns ? UINT32_MAX : (1U << matcher.size()) - 1;
+
+    auto worker = [&](size_t thread) {
+        size_t block;
+        while ((block = nextBlock.fetch_add(1, std::memory_order_relaxed)) < blockCount) {
+            size_t start = block * kScanBlockSize;
+            size_t end = std::min(start + kScanBlockSize, size);
+            size_t length = std::min(end - start + overlap, size - start);
+            matcher.scan(data + start, length, enabled, [&](size_t index, size_t offset) {
+                if (start + offset < end) {
+                    found[thread].push_back({registryIndex[index], start + offset});
+                }
+            });
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threadCount; i++) {
+        workers.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto &t : workers) {
+        t.join();
+    }
+
+    std::vector<ScanMatch> matches;
+    for (auto &list : found) {
+        matches.insert(matches.end(), list.begin(), list.end());
+    }
+    std::sort(matches.begin(), matches.end(), [](const ScanMatch &a, const ScanMatch &b) {
+        return a.patch != b.patch ? a.patch < b.patch : a.offset < b.offset;
+    });
+
+    // Blocks are scanned independently, drop matches overlapping a previous one of the same
+    // patch to keep the non-overlapping semantics of a sequential pass
+    std::vector<ScanMatch> result;
+    for (auto &match : matches) {
+        if (!result.empty() && result.back().patch == match.patch &&
+            result.back().offset + kPatchDescriptors[match.patch].size > match.offset) {
+            continue;
+        }
+        result.push_back(match);
+    }
+    return result;
+}
+
+struct ScanResult {
+    const char *path;
+    size_t size;
+    size_t threads;
+    bool isCache;       // file starts with a dyld_cache_header
+    std::vector<uint32_t> patches;  // registry indices looked for
+    std::vector<ScanMatch> matches; // sorted by patch then offset
+    bool mapped;        // target ranges looked for with -r
+    CacheMapStatus mapStatus;
+    std::vector<CacheRange> ranges;
+};
+
+struct MappedFile {
+    const uint8_t *data;
+    size_t size;
+};
+
+static bool readMappedFile(void *context, uint64_t offset, void *buffer, size_t size) {
+    auto file = static_cast<MappedFile *>(context);
+    if (offset > file->size || size > file->size - offset) {
+        return false;
+    }
+    memcpy(buffer, file->data + offset, size);
+    return true;
+}
+
+// Same limits as the kext, a cache needing more ranges is not filtered by it
+static constexpr size_t kMaxScanRanges = 32;
+
+static void mapTargetRanges(const uint8_t *data, size_t size, std::vector<CacheLayout> &layouts, ScanResult &result) {
+    MappedFile file {data, size};
+    std::vector<CacheMapScratch> scratch(1);
+    CacheRange ranges[kMaxScanRanges];
+    size_t count = 0;
+    result.mapped = true;
+    if (!result.isCache) {
+        result.mapStatus = mapMachTargets(readMappedFile, &file, size, kBinaryTargetSections, arrsize(kBinaryTargetSections), scratch[0], ranges, count, kMaxScanRanges);
+        result.ranges.assign(ranges, ranges + count);
+        return;
+    }
+    result.mapStatus = mapCacheTargets(readMappedFile, &file, size, kCacheTargets, layouts.data(), layouts.size(), scratch[0], ranges, count, kMaxScanRanges);
+    result.ranges.assign(ranges, ranges + count);
+    if (scratch[0].layout.subCacheCount > 0) {
+        layouts.push_back(scratch[0].layout);
+    }
+}
+
+static bool scanFile(const char *path, const ScanOptions &options, std::vector<CacheLayout> &layouts, ScanResult &result) {
+    PatchTarget target = PatchTarget::SharedCache;
+    bool anyTarget = options.allPatches;
+    if (!anyTarget && !targetFromPath(path, target)) {
+        fprintf(stderr, "%s: unknown file type, use -a to look for every patch set\n", path);
+        return false;
+    }
+
+    MultiPatternMatcher matcher;
+    uint32_t registryIndex[kMaxMatchPatterns];
+    size_t overlap = 0;
+    for (size_t i = 0; i < arrsize(kPatchDescriptors); i++) {
+        const PatchDescriptor &patch = kPatchDescriptors[i];
+        if (!anyTarget && patch.target != target) {
+            continue;
+        }
+        int index = matcher.add(patch.pattern());
+        if (index < 0) {
+            fprintf(stderr, "%s: failed to register %s\n", path, patch.name);
+            return false;
+        }
+        registryIndex[index] = static_cast<uint32_t>(i);
+        result.patches.push_back(static_cast<uint32_t>(i));
+        overlap = std::max(overlap, patch.size - 1);
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    const uint8_t *data = nullptr;
+    if (size > 0) {
+        void *map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            fprintf(stderr, "%s: mmap failed: %s\n", path, strerror(errno));
+            close(fd);
+            return false;
+        }
+        madvise(map, size, MADV_WILLNEED);
+        data = static_cast<const uint8_t *>(map);
+    }
+    close(fd);
+
+    size_t threadCount = options.threads;
+    if (threadCount == 0) {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    threadCount = std::max<size_t>(std::min(threadCount, (size + kScanBlockSize - 1) / kScanBlockSize), 1);
+
+    result.path = path;
+    result.size = size;
+    result.threads = threadCount;
+    result.isCache = data && size >= kDyldCacheHeaderSize && memcmp(data, kDyldCacheMagic, sizeof(kDyldCacheMagic) - 1) == 0;
+    if (size > 0) {
+        result.matches = scanBuffer(data, size, matcher, registryIndex, overlap, threadCount);
+        // Binaries are only mapped when named as one, as the kext classifies them
+        if (options.mapRanges && (result.isCache || (!anyTarget && target != PatchTarget::SharedCache))) {
+            mapTargetRanges(data, size, layouts, result);
+        }
+        munmap(const_cast<uint8_t *>(data), size);
+    }
+    return true;
+}
+
+static const char *cacheMapStatusName(CacheMapStatus status) {
+    switch (status) {
+        case CacheMapStatus::Mapped:
+            return "mapped";
+        case CacheMapStatus::NotCache:
+            return "not a cache";
+        case CacheMapStatus::NoTargets:
+            return "no target image";
+        case CacheMapStatus::SubCache:
+            return "sub cache of a main cache not given before";
+        case CacheMapStatus::Malformed:
+            return "malformed";
+        case CacheMapStatus::Overflow:
+            return "too many ranges";
+    }
+    return "unknown";
+}
+
+static void printReport(const ScanResult &result, const ScanOptions &options) {
+    printf("%s: %zu bytes, %zu pages of %zu bytes, %zu threads\n", result.path, result.size,
+           (result.size + options.pageSize - 1) / options.pageSize, options.pageSize, result.threads);
+    // Only pages intersecting a range are scanned by the kext once a cache is mapped
+    bool filtered = result.mapped && (result.mapStatus == CacheMapStatus::Mapped || result.mapStatus == CacheMapStatus::NoTargets);
+    if (result.mapped) {
+        size_t pages = 0;
+        uint64_t lastPage = UINT64_MAX;
+        for (auto &range : result.ranges) {
+            uint64_t first = range.begin / options.pageSize;
+            pages += (range.end + options.pageSize - 1) / options.pageSize - first - (first == lastPage);
+            lastPage = (range.end - 1) / options.pageSize;
+        }
+        printf("  target ranges: %s, %zu ranges, %zu of %zu pages scanned\n", cacheMapStatusName(result.mapStatus), result.ranges.size(),
+               filtered ? pages : (result.size + options.pageSize - 1) / options.pageSize, (result.size + options.pageSize - 1) / options.pageSize);
+        for (auto &range : result.ranges) {
+            printf("    0x%llx - 0x%llx\n", static_cast<unsigned long long>(range.begin), static_cast<unsigned long long>(range.end));
+        }
+    }
+    auto &matches = result.matches;
+    for (uint32_t patch : result.patches) {
+        const PatchDescriptor &desc = kPatchDescriptors[patch];
+        auto first = std::lower_bound(matches.begin(), matches.end(), patch, [](const ScanMatch &m, uint32_t p) { return m.patch < p; });
+        auto last = std::upper_bound(first, matches.end(), patch, [](uint32_t p, const ScanMatch &m) { return p < m.patch; });
+        size_t straddling = 0;
+        for (auto it = first; it != last; ++it) {
+            straddling += it->offset / options.pageSize != (it->offset + desc.size - 1) / options.pageSize;
+        }
+        printf("  %s: %zu matches, %zu straddling\n", desc.name, static_cast<size_t>(last - first), straddling);
+        for (auto it = first; it != last; ++it) {
+            size_t page = it->offset / options.pageSize;
+            bool straddles = page != (it->offset + desc.size - 1) / options.pageSize;
+            bool outside = filtered && !intersectsCacheRanges(result.ranges.data(), result.ranges.size(), it->offset, desc.size);
+            printf("    0x%zx page %zu%s%s\n", it->offset, page, straddles ? " straddles" : "", outside ? " outside target ranges" : "");
+        }
+    }
+}
+
+static void usage(const char *name) {
+    fprintf(stderr, "Usage: %s [-a] [-r] [-j threads] [-p page_size] file...\n", name);
+    fprintf(stderr, "  -a  look for every patch set regardless of the file name\n");
+    fprintf(stderr, "  -r  list the target ranges of shared caches and binaries and matches outside of them\n");
+    fprintf(stderr, "  -j  number of scanning threads, all cores by default\n");
+    fprintf(stderr, "  -p  page size used for page indices, 4096 by default\n");
+}
+
+int main(int argc, char *argv[]) {
+    ScanOptions options;
+    int opt;
+    while ((opt = getopt(argc, argv, "arj:p:")) != -1) {
+        switch (opt) {
+            case 'a':
+                options.allPatches = true;
+                break;
+            case 'r':
+                options.mapRanges = true;
+                break;
+            case 'j':
+                options.threads = strtoul(optarg, nullptr, 0);
+                break;
+            case 'p':
+                options.pageSize = strtoul(optarg, nullptr, 0);
+                if (options.pageSize == 0) {
+                    usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                break;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (optind == argc) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    bool success = true;
+    std::vector<CacheLayout> layouts;
+    for (int i = optind; i < argc; i++) {
+        ScanResult result {};
+        if (!scanFile(argv[i], options, layouts, result)) {
+            success = false;
+            continue;
+        }
+        printReport(result, options);
+    }
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
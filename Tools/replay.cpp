@@ -0,0 +1,474 @@
+//
+//  replay.cpp
+//  FeatureUnlock
+//
+//  Copyright © 2026 acidanthera. All rights reserved.
+//
+
+// Replays a stream of page validations through the unmodified kext sources linked
+// against the host shim, reporting the throughput of the routed validation hook.
+// Every configuration runs in a fresh process, as pluginStart state is global.
+//
+// Build from the repository root:
+//   c++ -std=gnu++14 -O2 -pthread -ITools/Shim -DPRODUCT_NAME=FeatureUnlock -DMODULE_VERSION=1.1.8
+//       FeatureUnlock/kern_start.cpp Tools/Shim/kern_shim.cpp Tools/replay.cpp -o replay
+//
+// Usage:
+//   replay [-c config]... [-b boot-args] [-j threads] [-n passes] [-s] [-t trace] [file...]
+//
+// The stream is every page of the given files in order, or the pages listed by a
+// trace with one "<file> <offset>" pair per line. Files are presented to the hook
+// under their path on the replayed OS, based on their name (dyld_shared_cache*,
+// UniversalControl, ControlCenter).
+// A configuration is model@kernel[.minor][+vmm][+cpu generation], for example
+// MacBookPro11,4@22.4+haswell.
+// With -j the stream is split between 1, 2, 4 and up to the given number of threads
+// calling the hook concurrently, showing how the shared patch state scales.
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <Headers/plugin_start.hpp>
+#include "Shim/kern_shim.hpp"
+#include "../FeatureUnlock/kern_usr_patch.hpp"
+
+// Pages are copied into a batch before timing, the hook patches them in place
+static constexpr size_t kReplayBatchPages = 256;
+
+struct ReplayFile {
+    std::string path;
+    const uint8_t *data;
+    size_t size;
+};
+
+struct ReplayPage {
+    uint32_t file;
+    uint64_t offset;
+};
+
+struct ReplayConfig {
+    std::string name;
+    ShimHost host;
+};
+
+struct ReplayResult {
+    uint64_t ns;
+    uint64_t pages;
+    uint32_t loops;
+    uint32_t allowedLoops;
+};
+
+static const struct {
+    const char *name;
+    CPUInfo::CpuGeneration generation;
+} kReplayCpuGenerations[] {
+    {"penryn", CPUInfo::CpuGeneration::Penryn},
+    {"nehalem", CPUInfo::CpuGeneration::Nehalem},
+    {"westmere", CPUInfo::CpuGeneration::Westmere},
+    {"sandybridge", CPUInfo::CpuGeneration::SandyBridge},
+    {"ivybridge", CPUInfo::CpuGeneration::IvyBridge},
+    {"haswell", CPUInfo::CpuGeneration::Haswell},
+    {"broadwell", CPUInfo::CpuGeneration::Broadwell},
+    {"skylake", CPUInfo::CpuGeneration::Skylake},
+    {"kabylake", CPUInfo::CpuGeneration::KabyLake},
+    {"coffeelake", CPUInfo::CpuGeneration::CoffeeLake},
+    {"cometlake", CPUInfo::CpuGeneration::CometLake},
+    {"icelake", CPUInfo::CpuGeneration::IceLake},
+};
+
+// Used when no configuration is given, covering both hooks, every patch target and a native model
+static const char *kReplayDefaultConfigs[] {
+    "MacBookPro11,4@22.4+haswell",
+    "iMac13,1@21.4+ivybridge",
+    "MacBookPro8,1@20+sandybridge",
+    "MacBookPro11,4@19+haswell",
+    "iMac20,1@23+cometlake",
+};
+
+static bool parseConfig(const char *text, ReplayConfig &config) {
+    const char *at = strchr(text, '@');
+    if (!at || static_cast<size_t>(at - text) >= sizeof(config.host.model)) {
+        return false;
+    }
+    config.name = text;
+    config.host = {};
+    memcpy(config.host.model, text, at - text);
+    config.host.cpuGeneration = CPUInfo::CpuGeneration::Haswell;
+
+    char *end;
+    config.host.kernel = static_cast<KernelVersion>(strtoul(at + 1, &end, 10));
+    if (*end == '.') {
+        config.host.kernelMinor = static_cast<KernelMinorVersion>(strtoul(end + 1, &end, 10));
+    }
+    while (*end == '+') {
+        const char *option = end + 1;
+        end = const_cast<char *>(option + strcspn(option, "+"));
+        size_t length = static_cast<size_t>(end - option);
+        if (length == 3 && strncmp(option, "vmm", length) == 0) {
+            config.host.vmmPresent = 1;
+            continue;
+        }
+        bool found = false;
+        for (auto &cpu : kReplayCpuGenerations) {
+            if (strlen(cpu.name) == length && strncmp(option, cpu.name, length) == 0) {
+                config.host.cpuGeneration = cpu.generation;
+                found = true;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+    }
+    return *end == '\0' && config.host.kernel >= KernelVersion::Sierra;
+}
+
+static int mapFile(std::vector<ReplayFile> &files, const char *path) {
+    for (size_t i = 0; i < files.size(); i++) {
+        if (files[i].path == path) {
+            return static_cast<int>(i);
+        }
+    }
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    struct stat st;
+    void *map = nullptr;
+    if (fstat(fd, &st) != 0 || st.st_size == 0 ||
+        (map = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+        fprintf(stderr, "%s: cannot map file\n", path);
+        close(fd);
+        return -1;
+    }
+    close(fd);
+    files.push_back({path, static_cast<const uint8_t *>(map), static_cast<size_t>(st.st_size)});
+    return static_cast<int>(files.size() - 1);
+}
+
+static bool loadTrace(const char *path, std::vector<ReplayFile> &files, std::vector<ReplayPage> &pages) {
+    FILE *trace = fopen(path, "r");
+    if (!trace) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return false;
+    }
+    char line[4096 + 64];
+    size_t number = 0;
+    bool success = true;
+    while (success && fgets(line, sizeof(line), trace)) {
+        number++;
+        char file[4096];
+        unsigned long long offset;
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        int index;
+        if (sscanf(line, "%4095s %lli", file, &offset) != 2 || (index = mapFile(files, file)) < 0 || offset >= files[index].size) {
+            fprintf(stderr, "%s:%zu: invalid page\n", path, number);
+            success = false;
+            break;
+        }
+        pages.push_back({static_cast<uint32_t>(index), offset & ~static_cast<uint64_t>(PAGE_SIZE - 1)});
+    }
+    fclose(trace);
+    return success;
+}
+
+// Path the kext expects the file at on the replayed OS
+static std::string guestPath(const std::string &path) {
+    size_t slash = path.rfind('/');
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    if (name.compare(0, strlen("dyld_shared_cache"), "dyld_shared_cache") == 0) {
+        return shimSharedCacheDirectory() + name;
+    }
+    if (name == "UniversalControl") {
+        return universalControlPath;
+    }
+    if (name == "ControlCenter") {
+        return controlCenterPath;
+    }
+    return path;
+}
+
+using ValidatePage = void (*)(vnode_t, memory_object_t, memory_object_offset_t, const void *, int *, int *, int *);
+using ValidateRange = boolean_t (*)(vnode_t, memory_object_t, memory_object_offset_t, const void *, vm_size_t, unsigned *);
+
+static inline void validate(ValidatePage validatePage, ValidateRange validateRange, vnode_t vp, uint64_t offset, uint8_t *data) {
+    if (validatePage) {
+        int validated, tainted, nx;
+        validatePage(vp, nullptr, offset, data, &validated, &tainted, &nx);
+    } else {
+        unsigned flags;
+        validateRange(vp, nullptr, offset, data, PAGE_SIZE, &flags);
+    }
+}
+
+static void copyPage(const std::vector<ReplayFile> &files, const ReplayPage &page, uint8_t *data) {
+    const ReplayFile &file = files[page.file];
+    size_t length = std::min<size_t>(PAGE_SIZE, file.size - page.offset);
+    memcpy(data, file.data + page.offset, length);
+    memset(data + length, 0, PAGE_SIZE - length);
+}
+
+// Runs in a child process, pluginStart may only be called once
+static ReplayResult replay(const ReplayConfig &config, const std::vector<ReplayFile> &files, const std::vector<ReplayPage> &pages, size_t threads, bool printStats) {
+    shimHost() = config.host;
+    ADDPR(config).pluginStart();
+    shimLoadPatcher();
+    if (printStats) {
+        // Timing is off by default, every invocation is timed for the statistics
+        uint32_t sampleRate = 1;
+        shimWriteSysctl("kern.featureunlock.sample_rate", &sampleRate, sizeof(sampleRate));
+    }
+    auto validatePage = reinterpret_cast<ValidatePage>(shimRoute("_cs_validate_page"));
+    auto validateRange = reinterpret_cast<ValidateRange>(shimRoute("_cs_validate_range"));
+    if (!validatePage && !validateRange) {
+        fprintf(stderr, "%s: validation hook not routed\n", config.name.c_str());
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<std::string> paths;
+    std::vector<vnode> vnodes;
+    for (auto &file : files) {
+        paths.push_back(guestPath(file.path));
+    }
+    for (size_t i = 0; i < files.size(); i++) {
+        vnodes.push_back({paths[i].c_str(), static_cast<uint32_t>(i + 1), shimMount(paths[i].c_str()), files[i].path.c_str()});
+    }
+
+    ReplayResult result {0, pages.size(), 0, 0};
+    if (threads > 0) {
+        // Whole stream copied upfront, threads take interleaved batches and the wall time is measured
+        std::vector<uint8_t> stream(pages.size() * PAGE_SIZE);
+        for (size_t i = 0; i < pages.size(); i++) {
+            copyPage(files, pages[i], &stream[i * PAGE_SIZE]);
+        }
+        auto worker = [&](size_t thread) {
+            for (size_t first = thread * kReplayBatchPages; first < pages.size(); first += threads * kReplayBatchPages) {
+                size_t last = std::min(first + kReplayBatchPages, pages.size());
+                for (size_t i = first; i < last; i++) {
+                    validate(validatePage, validateRange, &vnodes[pages[i].file], pages[i].offset, &stream[i * PAGE_SIZE]);
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        uint64_t start = mach_absolute_time();
+        for (size_t thread = 0; thread < threads; thread++) {
+            workers.emplace_back(worker, thread);
+        }
+        for (auto &thread : workers) {
+            thread.join();
+        }
+        result.ns = mach_absolute_time() - start;
+    } else {
+        std::vector<uint8_t> batch(kReplayBatchPages * PAGE_SIZE);
+        for (size_t first = 0; first < pages.size(); first += kReplayBatchPages) {
+            size_t count = std::min(kReplayBatchPages, pages.size() - first);
+            for (size_t i = 0; i < count; i++) {
+                copyPage(files, pages[first + i], &batch[i * PAGE_SIZE]);
+            }
+            uint64_t start = mach_absolute_time();
+            for (size_t i = 0; i < count; i++) {
+                validate(validatePage, validateRange, &vnodes[pages[first + i].file], pages[first + i].offset, &batch[i * PAGE_SIZE]);
+            }
+            result.ns += mach_absolute_time() - start;
+        }
+    }
+    size_t size = sizeof(result.loops);
+    shimReadSysctl("kern.featureunlock.dyld_loops", &result.loops, size);
+    size = sizeof(result.allowedLoops);
+    shimReadSysctl("kern.featureunlock.dyld_allowed_loops", &result.allowedLoops, size);
+
+    if (printStats) {
+        static const char *hooks[] {"hook_shared_cache", "hook_universal_control", "hook_control_center", "hook_other", "hook_bypassed"};
+        printf("kern.featureunlock:");
+        for (auto hook : hooks) {
+            uint64_t count = 0;
+            size_t size = sizeof(count);
+            shimReadSysctl((std::string("kern.featureunlock.") + hook).c_str(), &count, size);
+            printf(" %s %llu", hook, static_cast<unsigned long long>(count));
+        }
+        printf("\n");
+        static const char *nodes[] {"kern.featureunlock.patches", "kern.featureunlock.latency"};
+        for (auto node : nodes) {
+            char buffer[8192];
+            size_t size = sizeof(buffer);
+            if (shimReadSysctl(node, buffer, size) && size > 0) {
+                printf("%s:\n%s", node, buffer);
+            }
+        }
+        fflush(stdout);
+    }
+    return result;
+}
+
+// Fastest of the passes, each in a fresh process
+static bool runPasses(const ReplayConfig &config, const std::vector<ReplayFile> &files, const std::vector<ReplayPage> &pages, size_t threads, size_t passes, bool printStats, ReplayResult &best) {
+    best = {UINT64_MAX, 0, 0, 0};
+    for (size_t pass = 0; pass < passes; pass++) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            return false;
+        }
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            return false;
+        }
+        if (pid == 0) {
+            close(fds[0]);
+            ReplayResult result = replay(config, files, pages, threads, printStats && pass + 1 == passes);
+            bool written = write(fds[1], &result, sizeof(result)) == static_cast<ssize_t>(sizeof(result));
+            _exit(written ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+        close(fds[1]);
+        ReplayResult result;
+        bool received = read(fds[0], &result, sizeof(result)) == static_cast<ssize_t>(sizeof(result));
+        close(fds[0]);
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!received || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+            fprintf(stderr, "%s: replay failed\n", config.name.c_str());
+            return false;
+        }
+        if (result.ns < best.ns) {
+            best = result;
+        }
+    }
+    return true;
+}
+
+static bool runConfig(const ReplayConfig &config, const std::vector<ReplayFile> &files, const std::vector<ReplayPage> &pages, size_t passes, bool printStats) {
+    ReplayResult best;
+    if (!runPasses(config, files, pages, 0, passes, printStats, best)) {
+        return false;
+    }
+    double seconds = best.ns / 1e9;
+    double bytes = static_cast<double>(best.pages) * PAGE_SIZE;
+    printf("%s: %llu pages, %.3f ms, %.3f Mpages/s, %.3f GB/s, %.1f ns/page, dyld patches %u/%u\n", config.name.c_str(),
+           static_cast<unsigned long long>(best.pages), best.ns / 1e6, seconds > 0 ? best.pages / seconds / 1e6 : 0.0,
+           seconds > 0 ? bytes / seconds / 1e9 : 0.0, best.pages > 0 ? static_cast<double>(best.ns) / best.pages : 0.0,
+           best.loops, best.allowedLoops);
+    return true;
+}
+
+static bool runStress(const ReplayConfig &config, const std::vector<ReplayFile> &files, const std::vector<ReplayPage> &pages, size_t maxThreads, size_t passes, bool printStats) {
+    uint64_t single = 0;
+    for (size_t threads = 1; threads <= maxThreads; threads = threads < maxThreads && threads * 2 > maxThreads ? maxThreads : threads * 2) {
+        ReplayResult best;
+        if (!runPasses(config, files, pages, threads, passes, printStats && threads == maxThreads, best)) {
+            return false;
+        }
+        if (threads == 1) {
+            single = best.ns;
+        }
+        double seconds = best.ns / 1e9;
+        double speedup = best.ns > 0 ? static_cast<double>(single) / best.ns : 0.0;
+        printf("%s: %zu threads, %llu pages, %.3f ms, %.3f Mpages/s, speedup %.2f (efficiency %.0f%%), dyld patches %u/%u\n", config.name.c_str(),
+               threads, static_cast<unsigned long long>(best.pages), best.ns / 1e6, seconds > 0 ? best.pages / seconds / 1e6 : 0.0,
+               speedup, speedup * 100.0 / threads, best.loops, best.allowedLoops);
+        fflush(stdout);
+        if (threads == maxThreads) {
+            break;
+        }
+    }
+    return true;
+}
+
+static void usage(const char *name) {
+    fprintf(stderr, "Usage: %s [-c config]... [-b boot-args] [-j threads] [-n passes] [-s] [-t trace] [file...]\n", name);
+    fprintf(stderr, "  -c  model@kernel[.minor][+vmm][+cpu generation], several defaults when omitted\n");
+    fprintf(stderr, "  -b  boot arguments, for example \"-allow_sidecar_ipad -disable_nightshift\"\n");
+    fprintf(stderr, "  -j  split the stream between 1 up to the given number of threads\n");
+    fprintf(stderr, "  -n  passes per configuration, the fastest is reported (default 3)\n");
+    fprintf(stderr, "  -s  print kern.featureunlock statistics of the last pass, timing every invocation\n");
+    fprintf(stderr, "  -t  replay pages listed as \"<file> <offset>\" lines instead of whole files\n");
+}
+
+int main(int argc, char *argv[]) {
+    std::vector<ReplayConfig> configs;
+    const char *bootArgs = "";
+    const char *tracePath = nullptr;
+    size_t passes = 3;
+    size_t threads = 0;
+    bool printStats = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "c:b:j:n:st:")) != -1) {
+        switch (opt) {
+            case 'c': {
+                ReplayConfig config;
+                if (!parseConfig(optarg, config)) {
+                    fprintf(stderr, "%s: invalid configuration\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                configs.push_back(config);
+                break;
+            }
+            case 'b':
+                bootArgs = optarg;
+                break;
+            case 'j':
+                threads = std::max<size_t>(strtoul(optarg, nullptr, 0), 1);
+                break;
+            case 'n':
+                passes = std::max<size_t>(strtoul(optarg, nullptr, 0), 1);
+                break;
+            case 's':
+                printStats = true;
+                break;
+            case 't':
+                tracePath = optarg;
+                break;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (optind == argc && !tracePath) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (configs.empty()) {
+        for (auto text : kReplayDefaultConfigs) {
+            ReplayConfig config;
+            parseConfig(text, config);
+            configs.push_back(config);
+        }
+    }
+
+    std::vector<ReplayFile> files;
+    std::vector<ReplayPage> pages;
+    if (tracePath && !loadTrace(tracePath, files, pages)) {
+        return EXIT_FAILURE;
+    }
+    for (int i = optind; i < argc; i++) {
+        int index = mapFile(files, argv[i]);
+        if (index < 0) {
+            return EXIT_FAILURE;
+        }
+        for (uint64_t offset = 0; offset < files[index].size; offset += PAGE_SIZE) {
+            pages.push_back({static_cast<uint32_t>(index), offset});
+        }
+    }
+
+    bool success = true;
+    for (auto &config : configs) {
+        config.host.bootArgs = bootArgs;
+        success &= threads > 0 ? runStress(config, files, pages, threads, passes, printStats) :
+                                 runConfig(config, files, pages, passes, printStats);
+    }
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}